@@ -0,0 +1,497 @@
+#include "geometry_file.h"
+#include "mapped_file.h"
+
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+
+
+uint32_t constexpr geometry_file_magic = 0x4d4f4547; // "GEOM"
+uint32_t constexpr geometry_file_version = 2;
+size_t constexpr geometry_file_alignment = 64;
+size_t constexpr max_geometry_file_arrays_count = 15;
+
+static_assert(sizeof(GeometryFileHeader) == geometry_file_alignment, "header must keep alignment of arrays");
+static_assert(sizeof(float) == sizeof(uint32_t), "every element of arrays has 4 bytes");
+
+
+// offsets of arrays in order of fields of views
+struct GeometryFileLayout
+{
+    size_t arrays_count;
+    size_t offsets[max_geometry_file_arrays_count];
+
+    size_t file_size;
+};
+
+GeometryFileLayout get_geometry_file_layout(GeometryFileHeader const & header) noexcept
+{
+    GeometryFileLayout layout{};
+
+    size_t elements_counts[max_geometry_file_arrays_count]{};
+
+    if (header.type == GeometryFileType::Vvve)
+    {
+        layout.arrays_count = 4;
+        size_t const counts[] = { header.vertices_count, header.vertices_count, header.edges_count, header.edges_count };
+        std::copy(std::begin(counts), std::end(counts), elements_counts);
+    }
+    else
+    {
+        layout.arrays_count = 15;
+        size_t const counts[] = {
+            header.vertices_count, header.vertices_count, header.vertices_count, header.vertices_count,
+            header.edges_count, header.edges_count, header.edges_count, header.edges_count, header.edges_count, header.edges_count,
+            header.faces_count, header.faces_count,
+            header.free_vertices_count, header.free_faces_count, header.free_edges_count
+        };
+        std::copy(std::begin(counts), std::end(counts), elements_counts);
+    }
+
+    size_t current_offset = sizeof(GeometryFileHeader);
+
+    for (size_t i = 0; i < layout.arrays_count; ++i)
+    {
+        layout.offsets[i] = current_offset;
+
+        current_offset += sizeof(uint32_t) * elements_counts[i];
+        current_offset = (current_offset + geometry_file_alignment - 1) / geometry_file_alignment * geometry_file_alignment;
+    }
+
+    layout.file_size = current_offset;
+
+    return layout;
+}
+
+bool is_little_endian() noexcept
+{
+    uint32_t const value = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &value, 1);
+
+    return first_byte == 1;
+}
+
+uint32_t get_float_bits(float value) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// array is written in parts and padded to alignment, get_value(i) gives bits of i-th element
+template <typename GetValue>
+void write_geometry_file_array(std::ofstream & file, size_t elements_count, GetValue const & get_value) noexcept
+{
+    uint32_t buffer[4096];
+
+    for (size_t begin = 0; begin < elements_count; begin += std::size(buffer))
+    {
+        size_t const part_size = std::min(elements_count - begin, std::size(buffer));
+
+        for (size_t i = 0; i < part_size; ++i)
+        {
+            buffer[i] = get_value(begin + i);
+        }
+
+        file.write(reinterpret_cast<char const *>(buffer), static_cast<std::streamsize>(sizeof(uint32_t) * part_size));
+    }
+
+    char const padding[geometry_file_alignment]{};
+    size_t const padding_size = (geometry_file_alignment - sizeof(uint32_t) * elements_count % geometry_file_alignment) % geometry_file_alignment;
+
+    file.write(padding, static_cast<std::streamsize>(padding_size));
+}
+
+bool is_count_stored(size_t count) noexcept
+{
+    return count < std::numeric_limits<uint32_t>::max();
+}
+
+bool save_vvve_to_geometry_file(frm::vvve::VVVE const & vvve, std::string const & file_name) noexcept
+{
+    if (!is_little_endian() || !is_count_stored(vvve.vertices.size()) || !is_count_stored(vvve.edges.size()))
+    {
+        return false;
+    }
+
+    GeometryFileHeader header{};
+    header.magic = geometry_file_magic;
+    header.version = geometry_file_version;
+    header.type = GeometryFileType::Vvve;
+    header.vertices_count = static_cast<uint32_t>(vvve.vertices.size());
+    header.edges_count = static_cast<uint32_t>(vvve.edges.size());
+
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+    write_geometry_file_array(file, vvve.vertices.size(), [&vvve](size_t i) noexcept -> uint32_t
+        {
+            return get_float_bits(vvve.vertices[i].coordinate.x);
+        });
+    write_geometry_file_array(file, vvve.vertices.size(), [&vvve](size_t i) noexcept -> uint32_t
+        {
+            return get_float_bits(vvve.vertices[i].coordinate.y);
+        });
+    write_geometry_file_array(file, vvve.edges.size(), [&vvve](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(vvve.edges[i].begin);
+        });
+    write_geometry_file_array(file, vvve.edges.size(), [&vvve](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(vvve.edges[i].end);
+        });
+
+    return static_cast<bool>(file);
+}
+
+// flags are empty or given for every record
+bool are_flags_stored(std::vector<uint32_t> const & flags, size_t records_count) noexcept
+{
+    return flags.empty() || flags.size() == records_count;
+}
+
+bool save_dcel_to_geometry_file(frm::dcel::DCEL const & dcel, std::string const & file_name, DcelRecordsState const & state) noexcept
+{
+    if (!is_little_endian() ||
+        !is_count_stored(dcel.vertices.size()) || !is_count_stored(dcel.edges.size()) || !is_count_stored(dcel.faces.size()) ||
+        !is_count_stored(state.free_vertices.size()) || !is_count_stored(state.free_faces.size()) || !is_count_stored(state.free_edges.size()) ||
+        !are_flags_stored(state.vertices_flag, dcel.vertices.size()) ||
+        !are_flags_stored(state.edges_flag, dcel.edges.size()) ||
+        !are_flags_stored(state.faces_flag, dcel.faces.size()))
+    {
+        return false;
+    }
+
+    GeometryFileHeader header{};
+    header.magic = geometry_file_magic;
+    header.version = geometry_file_version;
+    header.type = GeometryFileType::Dcel;
+    header.vertices_count = static_cast<uint32_t>(dcel.vertices.size());
+    header.edges_count = static_cast<uint32_t>(dcel.edges.size());
+    header.faces_count = static_cast<uint32_t>(dcel.faces.size());
+    header.free_vertices_count = static_cast<uint32_t>(state.free_vertices.size());
+    header.free_faces_count = static_cast<uint32_t>(state.free_faces.size());
+    header.free_edges_count = static_cast<uint32_t>(state.free_edges.size());
+
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+    write_geometry_file_array(file, dcel.vertices.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return get_float_bits(dcel.vertices[i].coordinate.x);
+        });
+    write_geometry_file_array(file, dcel.vertices.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return get_float_bits(dcel.vertices[i].coordinate.y);
+        });
+    write_geometry_file_array(file, dcel.vertices.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.vertices[i].edge);
+        });
+    write_geometry_file_array(file, dcel.vertices.size(), [&state](size_t i) noexcept -> uint32_t
+        {
+            return state.vertices_flag.empty() ? 1 : state.vertices_flag[i];
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.edges[i].origin_vertex);
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.edges[i].twin_edge);
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.edges[i].incident_face);
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.edges[i].next_edge);
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.edges[i].previous_edge);
+        });
+    write_geometry_file_array(file, dcel.edges.size(), [&state](size_t i) noexcept -> uint32_t
+        {
+            return state.edges_flag.empty() ? 1 : state.edges_flag[i];
+        });
+    write_geometry_file_array(file, dcel.faces.size(), [&dcel](size_t i) noexcept -> uint32_t
+        {
+            return static_cast<uint32_t>(dcel.faces[i].edge);
+        });
+    write_geometry_file_array(file, dcel.faces.size(), [&state](size_t i) noexcept -> uint32_t
+        {
+            return state.faces_flag.empty() ? 1 : state.faces_flag[i];
+        });
+
+    std::vector<uint32_t> const * const free_lists[] = { &state.free_vertices, &state.free_faces, &state.free_edges };
+
+    for (std::vector<uint32_t> const * free_records : free_lists)
+    {
+        write_geometry_file_array(file, free_records->size(), [free_records](size_t i) noexcept -> uint32_t
+            {
+                return (*free_records)[i];
+            });
+    }
+
+    return static_cast<bool>(file);
+}
+
+MappedGeometryFile::~MappedGeometryFile() noexcept
+{
+    unmap_geometry_file(*this);
+}
+
+void unmap_geometry_file(MappedGeometryFile & mapped_file) noexcept
+{
+    if (mapped_file.data != nullptr)
+    {
+        unmap_file(mapped_file.data, mapped_file.size);
+    }
+
+    mapped_file.vvve = VvveView{};
+    mapped_file.dcel = DcelView{};
+    mapped_file.data = nullptr;
+    mapped_file.size = 0;
+}
+
+bool map_geometry_file(std::string const & file_name, MappedGeometryFile & mapped_file) noexcept
+{
+    unmap_geometry_file(mapped_file);
+
+    if (!is_little_endian())
+    {
+        return false;
+    }
+
+    void const * data = nullptr;
+    size_t size = 0;
+
+    if (!map_file_for_reading(file_name, data, size))
+    {
+        return false;
+    }
+
+    mapped_file.data = data;
+    mapped_file.size = size;
+
+    if (size < sizeof(GeometryFileHeader))
+    {
+        unmap_geometry_file(mapped_file);
+        return false;
+    }
+
+    GeometryFileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != geometry_file_magic ||
+        header.version != geometry_file_version ||
+        (header.type != GeometryFileType::Vvve && header.type != GeometryFileType::Dcel))
+    {
+        unmap_geometry_file(mapped_file);
+        return false;
+    }
+
+    GeometryFileLayout const layout = get_geometry_file_layout(header);
+
+    if (size < layout.file_size)
+    {
+        unmap_geometry_file(mapped_file);
+        return false;
+    }
+
+    char const * const bytes = static_cast<char const *>(data);
+
+    auto const get_floats = [bytes, &layout](size_t array_index) noexcept -> float const *
+    {
+        return reinterpret_cast<float const *>(bytes + layout.offsets[array_index]);
+    };
+    auto const get_indices = [bytes, &layout](size_t array_index) noexcept -> uint32_t const *
+    {
+        return reinterpret_cast<uint32_t const *>(bytes + layout.offsets[array_index]);
+    };
+
+    mapped_file.type = header.type;
+
+    if (header.type == GeometryFileType::Vvve)
+    {
+        VvveView & vvve = mapped_file.vvve;
+
+        vvve.vertices_count = header.vertices_count;
+        vvve.edges_count = header.edges_count;
+
+        vvve.vertices_x = get_floats(0);
+        vvve.vertices_y = get_floats(1);
+        vvve.edges_begin = get_indices(2);
+        vvve.edges_end = get_indices(3);
+    }
+    else
+    {
+        DcelView & dcel = mapped_file.dcel;
+
+        dcel.vertices_count = header.vertices_count;
+        dcel.edges_count = header.edges_count;
+        dcel.faces_count = header.faces_count;
+
+        dcel.vertices_x = get_floats(0);
+        dcel.vertices_y = get_floats(1);
+        dcel.vertices_edge = get_indices(2);
+        dcel.vertices_flag = get_indices(3);
+        dcel.edges_origin_vertex = get_indices(4);
+        dcel.edges_twin_edge = get_indices(5);
+        dcel.edges_incident_face = get_indices(6);
+        dcel.edges_next_edge = get_indices(7);
+        dcel.edges_previous_edge = get_indices(8);
+        dcel.edges_flag = get_indices(9);
+        dcel.faces_edge = get_indices(10);
+        dcel.faces_flag = get_indices(11);
+
+        dcel.free_vertices_count = header.free_vertices_count;
+        dcel.free_faces_count = header.free_faces_count;
+        dcel.free_edges_count = header.free_edges_count;
+
+        dcel.free_vertices = get_indices(12);
+        dcel.free_faces = get_indices(13);
+        dcel.free_edges = get_indices(14);
+    }
+
+    return true;
+}
+
+void copy_vvve_view(VvveView const & view, frm::vvve::VVVE & vvve) noexcept
+{
+    vvve = frm::vvve::VVVE{};
+
+    vvve.vertices.resize(view.vertices_count);
+    for (size_t i = 0; i < view.vertices_count; ++i)
+    {
+        vvve.vertices[i].coordinate = { view.vertices_x[i], view.vertices_y[i] };
+    }
+
+    vvve.edges.reserve(view.edges_count);
+    for (size_t i = 0; i < view.edges_count; ++i)
+    {
+        vvve.edges.push_back({ view.edges_begin[i], view.edges_end[i] });
+    }
+}
+
+void copy_dcel_view(DcelView const & view, frm::dcel::DCEL & dcel) noexcept
+{
+    dcel = frm::dcel::DCEL{};
+
+    dcel.vertices.resize(view.vertices_count);
+    for (size_t i = 0; i < view.vertices_count; ++i)
+    {
+        dcel.vertices[i].coordinate = { view.vertices_x[i], view.vertices_y[i] };
+        dcel.vertices[i].edge = view.vertices_edge[i];
+    }
+
+    dcel.edges.resize(view.edges_count);
+    for (size_t i = 0; i < view.edges_count; ++i)
+    {
+        dcel.edges[i].origin_vertex = view.edges_origin_vertex[i];
+        dcel.edges[i].twin_edge = view.edges_twin_edge[i];
+        dcel.edges[i].incident_face = view.edges_incident_face[i];
+        dcel.edges[i].next_edge = view.edges_next_edge[i];
+        dcel.edges[i].previous_edge = view.edges_previous_edge[i];
+    }
+
+    dcel.faces.resize(view.faces_count);
+    for (size_t i = 0; i < view.faces_count; ++i)
+    {
+        dcel.faces[i].edge = view.faces_edge[i];
+    }
+}
+
+bool save_vvve_view_to_text_file(VvveView const & view, std::string const & file_name) noexcept
+{
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    // floats are written with enough digits to be read back exactly
+    file.precision(9);
+
+    file << "{ " << view.vertices_count << '\n';
+    for (size_t i = 0; i < view.vertices_count; ++i)
+    {
+        file << "[ [ " << view.vertices_x[i] << " , " << view.vertices_y[i] << " ] ] ";
+    }
+
+    file << '\n' << view.edges_count << '\n';
+    for (size_t i = 0; i < view.edges_count; ++i)
+    {
+        file << "[ " << view.edges_begin[i] << " , " << view.edges_end[i] << " ] ";
+    }
+
+    file << "\n}";
+
+    return static_cast<bool>(file);
+}
+
+bool save_dcel_view_to_text_file(DcelView const & view, std::string const & file_name) noexcept
+{
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.precision(9);
+
+    file << "{ " << view.vertices_count << '\n';
+    for (size_t i = 0; i < view.vertices_count; ++i)
+    {
+        file << "[ [ " << view.vertices_x[i] << " , " << view.vertices_y[i] << " ]  , " << view.vertices_edge[i] << ", " << view.vertices_flag[i] << " ] ";
+    }
+
+    file << '\n' << view.faces_count << '\n';
+    for (size_t i = 0; i < view.faces_count; ++i)
+    {
+        file << "[ " << view.faces_edge[i] << ", " << view.faces_flag[i] << " ] ";
+    }
+
+    file << '\n' << view.edges_count << '\n';
+    for (size_t i = 0; i < view.edges_count; ++i)
+    {
+        file << "[ " << view.edges_origin_vertex[i] << " , " << view.edges_twin_edge[i] << " , " << view.edges_incident_face[i] << " , "
+            << view.edges_next_edge[i] << " , " << view.edges_previous_edge[i] << ", " << view.edges_flag[i] << " ] ";
+    }
+
+    // lists of free vertices, faces and edges
+    size_t const free_records_counts[] = { view.free_vertices_count, view.free_faces_count, view.free_edges_count };
+    uint32_t const * const free_records[] = { view.free_vertices, view.free_faces, view.free_edges };
+
+    for (size_t i = 0; i < std::size(free_records); ++i)
+    {
+        file << '\n' << free_records_counts[i] << '\n';
+        for (size_t j = 0; j < free_records_counts[i]; ++j)
+        {
+            file << free_records[i][j] << ' ';
+        }
+    }
+
+    file << "\n}";
+
+    return static_cast<bool>(file);
+}
\ No newline at end of file
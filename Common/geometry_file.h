@@ -0,0 +1,128 @@
+#pragma once
+
+
+#include "dcel.h"
+#include "vvve.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// binary form of Vvse_*.dat and Dcel_*.dat: header and arrays of numbers, every array begins on 64-byte boundary
+// numbers are little-endian uint32_t and float, files are not saved or mapped on big-endian machines
+enum class GeometryFileType : uint32_t
+{
+    Vvve = 1,
+    Dcel = 2
+};
+
+struct GeometryFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    GeometryFileType type;
+    uint32_t vertices_count;
+    uint32_t edges_count;
+    // 0 for vvve
+    uint32_t faces_count;
+    // lengths of lists of free records of dcel, 0 for vvve
+    uint32_t free_vertices_count;
+    uint32_t free_faces_count;
+    uint32_t free_edges_count;
+    uint32_t reserved[7];
+};
+
+// arrays are vertices_x, vertices_y, edges_begin, edges_end
+struct VvveView
+{
+    size_t vertices_count;
+    size_t edges_count;
+
+    float const * vertices_x;
+    float const * vertices_y;
+
+    uint32_t const * edges_begin;
+    uint32_t const * edges_end;
+};
+
+// arrays are in order of fields
+struct DcelView
+{
+    size_t vertices_count;
+    size_t edges_count;
+    size_t faces_count;
+
+    float const * vertices_x;
+    float const * vertices_y;
+    // one of edges which begin in vertex
+    uint32_t const * vertices_edge;
+    uint32_t const * vertices_flag;
+
+    uint32_t const * edges_origin_vertex;
+    uint32_t const * edges_twin_edge;
+    uint32_t const * edges_incident_face;
+    uint32_t const * edges_next_edge;
+    uint32_t const * edges_previous_edge;
+    uint32_t const * edges_flag;
+
+    uint32_t const * faces_edge;
+    uint32_t const * faces_flag;
+
+    size_t free_vertices_count;
+    size_t free_faces_count;
+    size_t free_edges_count;
+
+    uint32_t const * free_vertices;
+    uint32_t const * free_faces;
+    uint32_t const * free_edges;
+};
+
+// last number of every record and lists of free records of text form of dcel, algorithms do not use them
+// empty flags mean that flag of every record is 1
+struct DcelRecordsState
+{
+    std::vector<uint32_t> vertices_flag;
+    std::vector<uint32_t> edges_flag;
+    std::vector<uint32_t> faces_flag;
+
+    std::vector<uint32_t> free_vertices;
+    std::vector<uint32_t> free_faces;
+    std::vector<uint32_t> free_edges;
+};
+
+// read-only file mapping, views point into it, only view of type is filled
+// indices in arrays are not checked
+struct MappedGeometryFile
+{
+    MappedGeometryFile() noexcept = default;
+    MappedGeometryFile(MappedGeometryFile const &) = delete;
+    MappedGeometryFile & operator=(MappedGeometryFile const &) = delete;
+    ~MappedGeometryFile() noexcept;
+
+    GeometryFileType type{ GeometryFileType::Vvve };
+    VvveView vvve{};
+    DcelView dcel{};
+
+    void const * data{ nullptr };
+    size_t size{ 0 };
+};
+
+
+// O(n), arrays are written in parts, memory use does not depend on n
+bool save_vvve_to_geometry_file(frm::vvve::VVVE const & vvve, std::string const & file_name) noexcept;
+bool save_dcel_to_geometry_file(frm::dcel::DCEL const & dcel, std::string const & file_name, DcelRecordsState const & state = DcelRecordsState{}) noexcept;
+
+// O(1), pages are read on first access
+// previous mapping of mapped_file is released, returns false if file is absent or has wrong format
+bool map_geometry_file(std::string const & file_name, MappedGeometryFile & mapped_file) noexcept;
+
+void unmap_geometry_file(MappedGeometryFile & mapped_file) noexcept;
+
+// O(n), copies for algorithms which take framework structures
+void copy_vvve_view(VvveView const & view, frm::vvve::VVVE & vvve) noexcept;
+void copy_dcel_view(DcelView const & view, frm::dcel::DCEL & dcel) noexcept;
+
+// O(n), text form which is read by frm::vvve::load_from_file and frm::dcel::load_from_file
+bool save_vvve_view_to_text_file(VvveView const & view, std::string const & file_name) noexcept;
+bool save_dcel_view_to_text_file(DcelView const & view, std::string const & file_name) noexcept;
\ No newline at end of file
@@ -0,0 +1,729 @@
+#include "geometry_generators.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <cmath>
+
+
+double constexpr pi = 3.14159265358979323846;
+
+
+struct HalfEdge
+{
+    size_t origin_vertex;
+    size_t twin_edge;
+    size_t incident_face;
+    size_t next_edge;
+    size_t previous_edge;
+};
+
+
+// splitmix64 of seed and index, every element takes its own indices so it can be generated in any order
+uint64_t get_generator_hash(uint64_t seed, uint64_t index) noexcept
+{
+    uint64_t hash = seed * 0x9e3779b97f4a7c15ull + index * 0xd1b54a32d192ed03ull + 0x632be59bd9b4e019ull;
+
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+
+    return hash ^ (hash >> 31);
+}
+
+// [0, 1)
+double get_generator_unit(uint64_t seed, uint64_t index) noexcept
+{
+    return static_cast<double>(get_generator_hash(seed, index) >> 11) / 9007199254740992.;
+}
+
+void write_dcel_vertex(std::ofstream & file, double x, double y, size_t edge) noexcept
+{
+    file << "[ [ " << static_cast<float>(x) << " , " << static_cast<float>(y) << " ]  , " << edge << ", 1 ] ";
+}
+
+void write_dcel_edge(std::ofstream & file, HalfEdge const & edge) noexcept
+{
+    file << "[ " << edge.origin_vertex << " , " << edge.twin_edge << " , " << edge.incident_face << " , "
+        << edge.next_edge << " , " << edge.previous_edge << ", 1 ] ";
+}
+
+bool save_random_point_cloud(std::string const & file_name, PointCloudShape shape, size_t points_count, size_t seed) noexcept
+{
+    double constexpr radius = 1000.;
+
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.precision(9);
+
+    size_t const clusters_count = std::max(static_cast<size_t>(std::cbrt(static_cast<double>(points_count))), size_t{ 1 });
+    double const cluster_deviation = radius / (4. * std::sqrt(static_cast<double>(clusters_count)));
+
+    size_t const grid_side = std::max(static_cast<size_t>(std::sqrt(static_cast<double>(points_count)) / 2.), size_t{ 1 });
+    double const grid_step = 2. * radius / static_cast<double>(grid_side);
+
+    file << "{ " << points_count << '\n';
+
+    for (size_t i = 0; i < points_count; ++i)
+    {
+        double const u = get_generator_unit(seed, 3 * i);
+        double const v = get_generator_unit(seed, 3 * i + 1);
+
+        double x = 0.;
+        double y = 0.;
+
+        switch (shape)
+        {
+        case PointCloudShape::Uniform:
+            x = (2. * u - 1.) * radius;
+            y = (2. * v - 1.) * radius;
+            break;
+        case PointCloudShape::Disk:
+            x = radius * std::sqrt(u) * std::cos(2. * pi * v);
+            y = radius * std::sqrt(u) * std::sin(2. * pi * v);
+            break;
+        case PointCloudShape::Circle:
+            x = radius * std::cos(2. * pi * u);
+            y = radius * std::sin(2. * pi * u);
+            break;
+        case PointCloudShape::Clustered:
+        {
+            // centers of clusters use other seed
+            size_t const cluster = get_generator_hash(seed, 3 * i + 2) % clusters_count;
+            double const center_x = (2. * get_generator_unit(seed + 1, 2 * cluster) - 1.) * radius;
+            double const center_y = (2. * get_generator_unit(seed + 1, 2 * cluster + 1) - 1.) * radius;
+
+            // Box-Muller transform
+            double const distance = cluster_deviation * std::sqrt(-2. * std::log(1. - u));
+            x = center_x + distance * std::cos(2. * pi * v);
+            y = center_y + distance * std::sin(2. * pi * v);
+            break;
+        }
+        case PointCloudShape::DegenerateGrid:
+            x = static_cast<double>(get_generator_hash(seed, 3 * i) % (grid_side + 1)) * grid_step - radius;
+            y = static_cast<double>(get_generator_hash(seed, 3 * i + 1) % (grid_side + 1)) * grid_step - radius;
+            break;
+        }
+
+        file << "[ [ " << static_cast<float>(x) << " , " << static_cast<float>(y) << " ]  ] ";
+    }
+
+    file << "\n0\n\n}";
+
+    return static_cast<bool>(file);
+}
+
+bool save_random_simple_polygon(std::string const & file_name, SimplePolygonShape shape, size_t vertices_count, size_t seed) noexcept
+{
+    double constexpr radius = 1000.;
+
+    size_t const n = std::max(vertices_count, size_t{ 3 });
+
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.precision(9);
+
+    file << "{ " << n << '\n';
+
+    if (shape == SimplePolygonShape::Star)
+    {
+        // angles grow, so polygon is star-shaped from origin
+        for (size_t k = 0; k < n; ++k)
+        {
+            double const angle = 2. * pi * (static_cast<double>(k) + 0.1 + 0.8 * get_generator_unit(seed, 2 * k)) / static_cast<double>(n);
+            double const distance = radius * (0.5 + 0.5 * get_generator_unit(seed, 2 * k + 1));
+
+            write_dcel_vertex(file, distance * std::cos(angle), distance * std::sin(angle), k);
+        }
+    }
+    else
+    {
+        // lower chain goes right by x = 0, 1, ..., upper chain goes back by x = ..., 1.5, 0.5
+        // upper vertex is over both neighbouring lower vertices by 1 + |gap walk|
+        // walks are integer, so upper chain is built by going back along the same steps
+        size_t const upper_count = (n - 1) / 2;
+        size_t const lower_count = n - upper_count;
+
+        auto const get_lower_step = [seed](size_t i) noexcept -> int64_t
+        {
+            return static_cast<int64_t>(get_generator_hash(seed, 2 * i) % 5) - 2;
+        };
+        auto const get_gap_step = [seed](size_t i) noexcept -> int64_t
+        {
+            return static_cast<int64_t>(get_generator_hash(seed, 2 * i + 1) % 3) - 1;
+        };
+
+        int64_t lower_y = 0;
+        int64_t gap_walk = 0;
+
+        for (size_t i = 0; i < lower_count; ++i)
+        {
+            write_dcel_vertex(file, static_cast<double>(i), static_cast<double>(lower_y), i);
+
+            if (i + 1 < lower_count)
+            {
+                lower_y += get_lower_step(i);
+            }
+            if (i + 1 < upper_count)
+            {
+                gap_walk += get_gap_step(i);
+            }
+        }
+
+        // lower_y is y of lower vertex lower_index
+        size_t lower_index = lower_count - 1;
+
+        for (size_t i = upper_count; i-- > 0;)
+        {
+            for (; lower_index > i + 1; --lower_index)
+            {
+                lower_y -= get_lower_step(lower_index - 1);
+            }
+
+            int64_t const left_lower_y = lower_y - get_lower_step(i);
+            int64_t const upper_y = std::max(left_lower_y, lower_y) + 1 + std::abs(gap_walk);
+
+            write_dcel_vertex(file, static_cast<double>(i) + 0.5, static_cast<double>(upper_y), lower_count + upper_count - 1 - i);
+
+            if (i > 0)
+            {
+                gap_walk -= get_gap_step(i - 1);
+            }
+        }
+    }
+
+    // inner face is 0, outside face is 1, edge k goes from vertex k, edge n + k is its twin
+    file << "\n2\n[ 0, 1 ] [ " << n << ", 1 ] ";
+
+    file << '\n' << 2 * n << '\n';
+    for (size_t k = 0; k < n; ++k)
+    {
+        write_dcel_edge(file, { k, n + k, 0, (k + 1) % n, (k + n - 1) % n });
+    }
+    for (size_t k = 0; k < n; ++k)
+    {
+        write_dcel_edge(file, { (k + 1) % n, k, 1, n + (k + n - 1) % n, n + (k + 1) % n });
+    }
+
+    // no free vertices, faces and edges
+    file << "\n0\n\n0\n\n0\n\n}";
+
+    return static_cast<bool>(file);
+}
+
+bool save_voronoi_like_subdivision(std::string const & file_name, size_t cells_per_side, size_t seed) noexcept
+{
+    double constexpr step = 10.;
+    // vertex of split stays in 0.2 * step of its grid vertex, with shear no edge is closer than 0.25 * step to vertical
+    double constexpr max_offset = 0.15 * step;
+    double constexpr split_offset = 0.05 * step;
+    double constexpr shear = 1.;
+
+    // directions are counted counterclockwise from east, opposite directions differ by 4
+    int constexpr east = 0;
+    int constexpr north_east = 1;
+    int constexpr north = 2;
+    int constexpr north_west = 3;
+    int constexpr west = 4;
+    int constexpr south_west = 5;
+    int constexpr south = 6;
+    int constexpr south_east = 7;
+
+    size_t const s = std::max(cells_per_side, size_t{ 1 });
+    size_t const n = s + 1;
+
+    // grid vertex (i, j) is vertex j * n + i, inner grid vertex has second vertex n * n + (j - 1) * (s - 1) + i - 1
+    // split of type 0 takes west and south edges to the first vertex, type 1 takes west and north edges
+    // edges of horizontal segments go first, then edges of vertical segments, then edges between vertices of split
+    size_t const vertical_edges_begin = 2 * s * n;
+    size_t const split_edges_begin = 4 * s * n;
+    size_t const edges_count = split_edges_begin + 2 * (s - 1) * (s - 1);
+    size_t const outside_face = s * s;
+
+    auto const is_inner = [s](size_t i, size_t j) noexcept
+    {
+        return i != 0 && j != 0 && i != s && j != s;
+    };
+
+    auto const get_split_type = [seed, n](size_t i, size_t j) noexcept -> int
+    {
+        return static_cast<int>(get_generator_hash(seed, 3 * (j * n + i) + 2) & 1);
+    };
+
+    auto const is_first_split_vertex = [&get_split_type](size_t i, size_t j, int direction) noexcept
+    {
+        return get_split_type(i, j) == 0 ?
+            direction == west || direction == south || direction == north_east :
+            direction == west || direction == north || direction == south_east;
+    };
+
+    // outgoing directions of vertex which has outgoing edge in direction at grid vertex (i, j)
+    auto const get_vertex_directions = [&](size_t i, size_t j, int direction, int(&directions)[4]) noexcept -> size_t
+    {
+        size_t directions_count = 0;
+
+        if (!is_inner(i, j))
+        {
+            if (i < s)
+            {
+                directions[directions_count++] = east;
+            }
+            if (j < s)
+            {
+                directions[directions_count++] = north;
+            }
+            if (i > 0)
+            {
+                directions[directions_count++] = west;
+            }
+            if (j > 0)
+            {
+                directions[directions_count++] = south;
+            }
+
+            return directions_count;
+        }
+
+        bool const is_first = is_first_split_vertex(i, j, direction);
+        bool const is_type_0 = get_split_type(i, j) == 0;
+
+        directions[0] = is_first ? west : east;
+        directions[1] = is_first == is_type_0 ? south : north;
+        directions[2] = is_type_0 ? (is_first ? north_east : south_west) : (is_first ? south_east : north_west);
+
+        return 3;
+    };
+
+    auto const get_vertex = [&](size_t i, size_t j, int direction) noexcept -> size_t
+    {
+        return !is_inner(i, j) || is_first_split_vertex(i, j, direction) ? j * n + i : n * n + (j - 1) * (s - 1) + i - 1;
+    };
+
+    auto const get_outgoing_edge = [&](size_t i, size_t j, int direction) noexcept -> size_t
+    {
+        switch (direction)
+        {
+        case east:
+            return 2 * (j * s + i);
+        case west:
+            return 2 * (j * s + i - 1) + 1;
+        case north:
+            return vertical_edges_begin + 2 * (j * n + i);
+        case south:
+            return vertical_edges_begin + 2 * ((j - 1) * n + i) + 1;
+        default:
+            return split_edges_begin + 2 * ((j - 1) * (s - 1) + i - 1) + !is_first_split_vertex(i, j, direction);
+        }
+    };
+
+    // grid vertex and direction of edge
+    auto const get_edge_origin = [&](size_t edge, size_t & i, size_t & j, int & direction) noexcept
+    {
+        bool const is_forward = edge % 2 == 0;
+
+        if (edge < vertical_edges_begin)
+        {
+            i = edge / 2 % s + !is_forward;
+            j = edge / 2 / s;
+            direction = is_forward ? east : west;
+        }
+        else if (edge < split_edges_begin)
+        {
+            i = (edge - vertical_edges_begin) / 2 % n;
+            j = (edge - vertical_edges_begin) / 2 / n + !is_forward;
+            direction = is_forward ? north : south;
+        }
+        else
+        {
+            i = (edge - split_edges_begin) / 2 % (s - 1) + 1;
+            j = (edge - split_edges_begin) / 2 / (s - 1) + 1;
+
+            int const first_direction = get_split_type(i, j) == 0 ? north_east : south_east;
+            direction = is_forward ? first_direction : (first_direction + 4) % 8;
+        }
+    };
+
+    // the next outgoing direction of the same vertex, clockwise or counterclockwise
+    auto const get_next_direction = [&](size_t i, size_t j, int direction, bool is_clockwise) noexcept -> int
+    {
+        int directions[4];
+        size_t const directions_count = get_vertex_directions(i, j, direction, directions);
+
+        int best_direction = direction;
+        int best_turn = 8;
+
+        for (size_t k = 0; k < directions_count; ++k)
+        {
+            int const turn = is_clockwise ? (direction - directions[k] + 8) % 8 : (directions[k] - direction + 8) % 8;
+
+            if (turn != 0 && turn < best_turn)
+            {
+                best_turn = turn;
+                best_direction = directions[k];
+            }
+        }
+
+        return best_direction;
+    };
+
+    // face on the left of edge is cell in the next quadrant counterclockwise
+    auto const get_left_face = [&](size_t i, size_t j, int direction) noexcept -> size_t
+    {
+        int const quadrant = direction % 2 == 0 ? direction + 1 : (direction + 2) % 8;
+
+        size_t const cell_i = quadrant == north_east || quadrant == south_east ? i : i - 1;
+        size_t const cell_j = quadrant == north_east || quadrant == north_west ? j : j - 1;
+
+        return cell_i < s && cell_j < s ? cell_j * s + cell_i : outside_face;
+    };
+
+    auto const write_vertex = [&](std::ofstream & file, size_t i, size_t j, int direction) noexcept
+    {
+        double x = static_cast<double>(i) * step;
+        double y = static_cast<double>(j) * step;
+
+        if (is_inner(i, j))
+        {
+            size_t const index = 3 * (j * n + i);
+
+            x += (2. * get_generator_unit(seed, index) - 1.) * max_offset;
+            y += (2. * get_generator_unit(seed, index + 1) - 1.) * max_offset;
+
+            double const side = is_first_split_vertex(i, j, direction) ? -1. : 1.;
+            double const slope = get_split_type(i, j) == 0 ? 0.5 : -0.5;
+
+            x += side * split_offset;
+            y += side * slope * split_offset;
+        }
+
+        write_dcel_vertex(file, x + shear * y, y, get_outgoing_edge(i, j, direction));
+    };
+
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.precision(9);
+
+    file << "{ " << n * n + (s - 1) * (s - 1) << '\n';
+    for (size_t j = 0; j < n; ++j)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            int directions[4];
+            get_vertex_directions(i, j, west, directions);
+
+            write_vertex(file, i, j, directions[0]);
+        }
+    }
+    for (size_t j = 1; j < s; ++j)
+    {
+        for (size_t i = 1; i < s; ++i)
+        {
+            int directions[4];
+            get_vertex_directions(i, j, east, directions);
+
+            write_vertex(file, i, j, directions[0]);
+        }
+    }
+
+    // cell (i, j) begins with its bottom edge, outside face begins with the bottom edge of the left cell
+    file << '\n' << outside_face + 1 << '\n';
+    for (size_t face = 0; face < outside_face; ++face)
+    {
+        file << "[ " << 2 * face << ", 1 ] ";
+    }
+    file << "[ 1, 1 ] ";
+
+    // next edge of face goes from the end of edge clockwise after twin
+    file << '\n' << edges_count << '\n';
+    for (size_t edge = 0; edge < edges_count; ++edge)
+    {
+        size_t origin_i;
+        size_t origin_j;
+        int direction;
+        get_edge_origin(edge, origin_i, origin_j, direction);
+
+        size_t end_i;
+        size_t end_j;
+        int twin_direction;
+        get_edge_origin(edge ^ 1, end_i, end_j, twin_direction);
+
+        int const next_direction = get_next_direction(end_i, end_j, twin_direction, true);
+        int const previous_twin_direction = get_next_direction(origin_i, origin_j, direction, false);
+
+        write_dcel_edge(file, {
+            get_vertex(origin_i, origin_j, direction),
+            edge ^ 1,
+            get_left_face(origin_i, origin_j, direction),
+            get_outgoing_edge(end_i, end_j, next_direction),
+            get_outgoing_edge(origin_i, origin_j, previous_twin_direction) ^ 1
+            });
+    }
+
+    // no free vertices, faces and edges
+    file << "\n0\n\n0\n\n0\n\n}";
+
+    return static_cast<bool>(file);
+}
+
+bool save_grid_subdivision_with_holes(std::string const & file_name, size_t cells_per_side, size_t seed) noexcept
+{
+    // cell is 4 x 4, hole is 2 x 2 in its middle, all coordinates are integer or half-integer
+    double constexpr step = 4.;
+    double constexpr shear = 0.5;
+
+    double constexpr corners_x[] = { 0., 1., 1., 0. };
+    double constexpr corners_y[] = { 0., 0., 1., 1. };
+
+    size_t const s = std::max(cells_per_side, size_t{ 1 });
+    size_t const n = s + 1;
+
+    // cells are numbered by rows, hole rank of cell is number of cells with holes before it
+    // cell without hole has face and edges bottom, right, top, left
+    // cell with hole has four trapezoids by sides and inner square, edge 4 * k + m is edge m of trapezoid k:
+    // outer side, diagonal to inner corner k + 1, inner side, diagonal from inner corner k
+    // edges 16 + k are sides of inner square, corners of square are vertices after grid vertices
+    // outside edges go clockwise after all edges of cells: bottom, left, top, right
+    auto const has_hole = [seed, s](size_t i, size_t j) noexcept
+    {
+        return get_generator_hash(seed, j * s + i) % 4 == 0;
+    };
+
+    std::vector<size_t> holes_before_row(n, 0);
+    for (size_t j = 0; j < s; ++j)
+    {
+        holes_before_row[j + 1] = holes_before_row[j];
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            holes_before_row[j + 1] += has_hole(i, j);
+        }
+    }
+
+    size_t const holes_count = holes_before_row[s];
+    size_t const outside_edges_begin = 4 * s * s + 16 * holes_count;
+    size_t const outside_face = s * s + 4 * holes_count;
+
+    // hole ranks of cells of rows j - 1, j, j + 1 while edges are written, rows out of grid are empty
+    std::vector<size_t> hole_ranks[3];
+
+    auto const fill_hole_ranks = [&](std::vector<size_t> & ranks, size_t j) noexcept
+    {
+        ranks.assign(j < s ? s : 0, 0);
+
+        size_t rank = j < s ? holes_before_row[j] : 0;
+        for (size_t i = 0; i < ranks.size(); ++i)
+        {
+            ranks[i] = rank;
+            rank += has_hole(i, j);
+        }
+    };
+
+    auto const get_cell_edges_begin = [s](size_t i, size_t j, size_t hole_rank) noexcept
+    {
+        return 4 * (j * s + i) + 16 * hole_rank;
+    };
+
+    auto const get_side_edge = [&](size_t i, size_t j, size_t hole_rank, size_t side) noexcept
+    {
+        return get_cell_edges_begin(i, j, hole_rank) + (has_hole(i, j) ? 4 * side : side);
+    };
+
+    auto const get_grid_vertex = [n](size_t i, size_t j, size_t corner) noexcept
+    {
+        return (j + (corner >= 2)) * n + i + (corner == 1 || corner == 2);
+    };
+
+    auto const get_hole_vertex = [n](size_t hole_rank, size_t corner) noexcept
+    {
+        return n * n + 4 * hole_rank + corner % 4;
+    };
+
+    std::ofstream file(file_name, std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.precision(9);
+
+    // grid vertex begins edge of cell which has it as the lowest corner
+    file << "{ " << n * n + 4 * holes_count << '\n';
+    for (size_t j = 0; j < n; ++j)
+    {
+        size_t const cell_j = std::min(j, s - 1);
+        fill_hole_ranks(hole_ranks[1], cell_j);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t const cell_i = std::min(i, s - 1);
+            size_t const corner = i == s ? (j == s ? 2 : 1) : (j == s ? 3 : 0);
+
+            double const y = static_cast<double>(j) * step;
+            write_dcel_vertex(file, static_cast<double>(i) * step + shear * y, y, get_side_edge(cell_i, cell_j, hole_ranks[1][cell_i], corner));
+        }
+    }
+    for (size_t j = 0; j < s; ++j)
+    {
+        fill_hole_ranks(hole_ranks[1], j);
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            if (!has_hole(i, j))
+            {
+                continue;
+            }
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                double const y = (static_cast<double>(j) + 0.25 + 0.5 * corners_y[k]) * step;
+                double const x = (static_cast<double>(i) + 0.25 + 0.5 * corners_x[k]) * step;
+
+                write_dcel_vertex(file, x + shear * y, y, get_cell_edges_begin(i, j, hole_ranks[1][i]) + 16 + k);
+            }
+        }
+    }
+
+    file << '\n' << outside_face + 1 << '\n';
+    for (size_t j = 0; j < s; ++j)
+    {
+        fill_hole_ranks(hole_ranks[1], j);
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            size_t const edges_begin = get_cell_edges_begin(i, j, hole_ranks[1][i]);
+            size_t const faces_count = has_hole(i, j) ? 5 : 1;
+
+            for (size_t k = 0; k < faces_count; ++k)
+            {
+                file << "[ " << edges_begin + 4 * k << ", 1 ] ";
+            }
+        }
+    }
+    file << "[ " << outside_edges_begin << ", 1 ] ";
+
+    file << '\n' << outside_edges_begin + 4 * s << '\n';
+
+    fill_hole_ranks(hole_ranks[2], 0);
+
+    for (size_t j = 0; j < s; ++j)
+    {
+        std::swap(hole_ranks[0], hole_ranks[1]);
+        std::swap(hole_ranks[1], hole_ranks[2]);
+        fill_hole_ranks(hole_ranks[2], j + 1);
+
+        size_t face = j * s + 4 * holes_before_row[j];
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            size_t const hole_rank = hole_ranks[1][i];
+            size_t const edges_begin = get_cell_edges_begin(i, j, hole_rank);
+
+            size_t twin_side_edges[4];
+            twin_side_edges[0] = j > 0 ? get_side_edge(i, j - 1, hole_ranks[0][i], 2) : outside_edges_begin + s - 1 - i;
+            twin_side_edges[1] = i + 1 < s ? get_side_edge(i + 1, j, hole_ranks[1][i + 1], 3) : outside_edges_begin + 4 * s - 1 - j;
+            twin_side_edges[2] = j + 1 < s ? get_side_edge(i, j + 1, hole_ranks[2][i], 0) : outside_edges_begin + 2 * s + i;
+            twin_side_edges[3] = i > 0 ? get_side_edge(i - 1, j, hole_ranks[1][i - 1], 1) : outside_edges_begin + s + j;
+
+            if (!has_hole(i, j))
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    write_dcel_edge(file, {
+                        get_grid_vertex(i, j, k),
+                        twin_side_edges[k],
+                        face,
+                        edges_begin + (k + 1) % 4,
+                        edges_begin + (k + 3) % 4
+                        });
+                }
+
+                ++face;
+                continue;
+            }
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                size_t const trapezoid = edges_begin + 4 * k;
+
+                size_t const origins[] = {
+                    get_grid_vertex(i, j, k),
+                    get_grid_vertex(i, j, (k + 1) % 4),
+                    get_hole_vertex(hole_rank, k + 1),
+                    get_hole_vertex(hole_rank, k)
+                };
+                size_t const twins[] = {
+                    twin_side_edges[k],
+                    edges_begin + 4 * ((k + 1) % 4) + 3,
+                    edges_begin + 16 + k,
+                    edges_begin + 4 * ((k + 3) % 4) + 1
+                };
+
+                for (size_t m = 0; m < 4; ++m)
+                {
+                    write_dcel_edge(file, { origins[m], twins[m], face + k, trapezoid + (m + 1) % 4, trapezoid + (m + 3) % 4 });
+                }
+            }
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                write_dcel_edge(file, {
+                    get_hole_vertex(hole_rank, k),
+                    edges_begin + 4 * k + 2,
+                    face + 4,
+                    edges_begin + 16 + (k + 1) % 4,
+                    edges_begin + 16 + (k + 3) % 4
+                    });
+            }
+
+            face += 5;
+        }
+    }
+
+    // outside edge is twin of side of border cell, its origin is the end of that side
+    fill_hole_ranks(hole_ranks[0], 0);
+    fill_hole_ranks(hole_ranks[1], s - 1);
+
+    auto const get_border_hole_rank = [&](size_t i, size_t j) noexcept
+    {
+        return i == 0 ? holes_before_row[j] : i == s - 1 ? holes_before_row[j + 1] - has_hole(i, j) : hole_ranks[j == 0 ? 0 : 1][i];
+    };
+
+    for (size_t k = 0; k < 4 * s; ++k)
+    {
+        size_t const side = k / s == 0 ? 0 : k / s == 1 ? 3 : k / s == 2 ? 2 : 1;
+        size_t const position = k % s;
+
+        size_t const i = side == 0 ? s - 1 - position : side == 3 ? 0 : side == 2 ? position : s - 1;
+        size_t const j = side == 0 ? 0 : side == 3 ? position : side == 2 ? s - 1 : s - 1 - position;
+
+        write_dcel_edge(file, {
+            get_grid_vertex(i, j, (side + 1) % 4),
+            get_side_edge(i, j, get_border_hole_rank(i, j), side),
+            outside_face,
+            outside_edges_begin + (k + 1) % (4 * s),
+            outside_edges_begin + (k + 4 * s - 1) % (4 * s)
+            });
+    }
+
+    // no free vertices, faces and edges
+    file << "\n0\n\n0\n\n0\n\n}";
+
+    return static_cast<bool>(file);
+}
\ No newline at end of file
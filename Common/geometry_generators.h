@@ -0,0 +1,43 @@
+#pragma once
+
+
+#include <string>
+
+
+enum class PointCloudShape
+{
+    Uniform,
+    Disk,
+    Circle,
+    Clustered,
+    // points on coarse lattice, many of them are equal or collinear
+    DegenerateGrid
+};
+
+enum class SimplePolygonShape
+{
+    // vertices go around center with growing angle and random radius
+    Star,
+    // x-monotone polygon, lower and upper chains are random walks
+    RandomWalk
+};
+
+
+// generators write records while they are computed, memory use does not depend on size of result
+// result depends only on arguments, random numbers are hashes of seed and index of element
+
+// Vvse_*.dat format without edges
+bool save_random_point_cloud(std::string const & file_name, PointCloudShape shape, size_t points_count, size_t seed) noexcept;
+
+// Dcel_*.dat format, inner face is counterclockwise, vertices_count >= 3
+// coordinates are floats, so vertices stay distinct up to about 10^7 vertices
+bool save_random_simple_polygon(std::string const & file_name, SimplePolygonShape shape, size_t vertices_count, size_t seed) noexcept;
+
+// Dcel_*.dat format, jittered grid of cells_per_side x cells_per_side cells where every inner vertex is split in two vertices
+// of degree 3 joined by short edge, cells have 4 - 8 edges like cells of Voronoi diagram, no edge is vertical
+bool save_voronoi_like_subdivision(std::string const & file_name, size_t cells_per_side, size_t seed) noexcept;
+
+// Dcel_*.dat format, grid of cells_per_side x cells_per_side square cells with integer coordinates
+// every fourth cell on average has square hole which is a face, ring around hole is split into four trapezoids
+// grid is sheared so no edge is vertical
+bool save_grid_subdivision_with_holes(std::string const & file_name, size_t cells_per_side, size_t seed) noexcept;
\ No newline at end of file
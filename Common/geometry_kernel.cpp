@@ -0,0 +1,444 @@
+#include "geometry_kernel.h"
+
+#include <emmintrin.h>
+
+
+size_t constexpr simd_width = 4;
+
+
+// exact arithmetic from Shewchuk's paper, number is expansion: sum of doubles which do not overlap
+
+// sum + error = a + b exactly
+void two_sum(double a, double b, double & sum, double & error) noexcept
+{
+    sum = a + b;
+
+    double const b_virtual = sum - a;
+    double const a_virtual = sum - b_virtual;
+
+    error = (a - a_virtual) + (b - b_virtual);
+}
+
+// high + low = a, both have at most 26 significant bits
+void split(double a, double & high, double & low) noexcept
+{
+    double constexpr splitter = 134217729.; // 2^27 + 1
+
+    double const c = splitter * a;
+    double const a_big = c - a;
+
+    high = c - a_big;
+    low = a - high;
+}
+
+// product + error = a * b exactly
+void two_product(double a, double b, double & product, double & error) noexcept
+{
+    product = a * b;
+
+    double a_high = 0.;
+    double a_low = 0.;
+    double b_high = 0.;
+    double b_low = 0.;
+
+    split(a, a_high, a_low);
+    split(b, b_high, b_low);
+
+    error = a_low * b_low - (((product - a_high * b_high) - a_low * b_high) - a_high * b_low);
+}
+
+int get_exact_cross_product_sign(frm::Point first_begin, frm::Point first_end, frm::Point second_begin, frm::Point second_end) noexcept
+{
+    // difference of floats is not always double, but it is sum of two doubles
+    auto const get_difference = [](float a, float b, double (& difference)[2]) noexcept
+    {
+        two_sum(static_cast<double>(a), -static_cast<double>(b), difference[1], difference[0]);
+    };
+
+    double first_x[2];
+    double first_y[2];
+    double second_x[2];
+    double second_y[2];
+
+    get_difference(first_end.x, first_begin.x, first_x);
+    get_difference(first_end.y, first_begin.y, first_y);
+    get_difference(second_end.x, second_begin.x, second_x);
+    get_difference(second_end.y, second_begin.y, second_y);
+
+    // components go from the smallest to the largest, zeros are not kept
+    double expansion[16];
+    size_t expansion_size = 0;
+
+    auto const add_to_expansion = [&expansion, &expansion_size](double value) noexcept
+    {
+        double sum = value;
+        size_t new_size = 0;
+
+        for (size_t i = 0; i < expansion_size; ++i)
+        {
+            double error = 0.;
+            two_sum(sum, expansion[i], sum, error);
+
+            if (error != 0.)
+            {
+                expansion[new_size++] = error;
+            }
+        }
+
+        if (sum != 0.)
+        {
+            expansion[new_size++] = sum;
+        }
+
+        expansion_size = new_size;
+    };
+
+    // usually differences are exact and only products of high parts are not zero
+    auto const add_product_to_expansion = [&add_to_expansion](double a, double b, double sign) noexcept
+    {
+        if (a == 0. || b == 0.)
+        {
+            return;
+        }
+
+        double product = 0.;
+        double error = 0.;
+
+        two_product(a, b, product, error);
+        add_to_expansion(sign * product);
+        add_to_expansion(sign * error);
+    };
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 2; ++j)
+        {
+            add_product_to_expansion(first_x[i], second_y[j], 1.);
+            add_product_to_expansion(first_y[i], second_x[j], -1.);
+        }
+    }
+
+    if (expansion_size == 0)
+    {
+        return 0;
+    }
+
+    // sign of expansion is sign of its largest component
+    return expansion[expansion_size - 1] > 0. ? 1 : -1;
+}
+
+// the same operations as get_cross_product and get_cross_product_sign, so results are equal
+void get_cross_product_terms_simd(frm::Point begin, frm::Point end, PointSpan points, size_t first_index,
+    __m128 & left_products, __m128 & right_products) noexcept
+{
+    __m128 const x = _mm_loadu_ps(points.x + first_index);
+    __m128 const y = _mm_loadu_ps(points.y + first_index);
+
+    __m128 const delta_x = _mm_set1_ps(end.x - begin.x);
+    __m128 const delta_y = _mm_set1_ps(end.y - begin.y);
+
+    left_products = _mm_mul_ps(delta_x, _mm_sub_ps(y, _mm_set1_ps(begin.y)));
+    right_products = _mm_mul_ps(delta_y, _mm_sub_ps(x, _mm_set1_ps(begin.x)));
+}
+
+__m128 get_abs_simd(__m128 value) noexcept
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.f), value);
+}
+
+// masks of lanes with positive and negative cross product, lanes where error bound does not prove sign are computed by scalar code
+void get_cross_product_signs_simd(frm::Point begin, frm::Point end, PointSpan points, size_t first_index,
+    __m128 left_products, __m128 right_products, __m128 & is_positive, __m128 & is_negative) noexcept
+{
+    __m128 const cross_products = _mm_sub_ps(left_products, right_products);
+    __m128 const error_bounds = _mm_mul_ps(
+        _mm_set1_ps(cross_product_relative_error_bound),
+        _mm_add_ps(get_abs_simd(left_products), get_abs_simd(right_products))
+    );
+
+    is_positive = _mm_cmpgt_ps(cross_products, error_bounds);
+    is_negative = _mm_cmpgt_ps(_mm_xor_ps(cross_products, _mm_set1_ps(-0.f)), error_bounds);
+
+    int const is_proven_mask = _mm_movemask_ps(_mm_or_ps(is_positive, is_negative));
+
+    if (is_proven_mask == 0xf)
+    {
+        return;
+    }
+
+    alignas(16) int32_t positive_lanes[simd_width];
+    alignas(16) int32_t negative_lanes[simd_width];
+    _mm_store_si128(reinterpret_cast<__m128i *>(positive_lanes), _mm_castps_si128(is_positive));
+    _mm_store_si128(reinterpret_cast<__m128i *>(negative_lanes), _mm_castps_si128(is_negative));
+
+    for (size_t lane = 0; lane < simd_width; ++lane)
+    {
+        if ((is_proven_mask >> lane) & 1)
+        {
+            continue;
+        }
+
+        size_t const index = first_index + lane;
+        int const sign = get_cross_product_sign(begin, end, { points.x[index], points.y[index] });
+
+        positive_lanes[lane] = sign > 0 ? -1 : 0;
+        negative_lanes[lane] = sign < 0 ? -1 : 0;
+    }
+
+    is_positive = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<__m128i const *>(positive_lanes)));
+    is_negative = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<__m128i const *>(negative_lanes)));
+}
+
+void get_sides(frm::Point begin, frm::Point end, PointSpan points, SideByLine * sides) noexcept
+{
+    for (size_t i = 0; i < points.size; ++i)
+    {
+        sides[i] = get_side(begin, end, { points.x[i], points.y[i] });
+    }
+}
+
+void get_distances_to_line(frm::Point begin, frm::Point end, PointSpan points, float * distances) noexcept
+{
+    for (size_t i = 0; i < points.size; ++i)
+    {
+        distances[i] = distance_to_line(begin, end, { points.x[i], points.y[i] });
+    }
+}
+
+// 1 if point is farther from line than other point, -1 if it is closer, 0 if distances are equal
+// both points are on side of line
+int compare_distances_to_line(frm::Point begin, frm::Point end, frm::Point point, frm::Point other_point, SideByLine side) noexcept
+{
+    if (side == SideByLine::OnLine)
+    {
+        return 0;
+    }
+
+    // difference of cross products is cross product of line and vector from other point to point
+    int const sign = get_cross_product_sign(begin, end, other_point, point);
+
+    return side == SideByLine::Right ? sign : -sign;
+}
+
+size_t get_farthest_point_on_side(frm::Point begin, frm::Point end, PointSpan points, SideByLine side) noexcept
+{
+    size_t index = points.size;
+
+    for (size_t i = 0; i < points.size; ++i)
+    {
+        frm::Point const point{ points.x[i], points.y[i] };
+
+        if (get_side(begin, end, point) != side)
+        {
+            continue;
+        }
+
+        if (index == points.size ||
+            compare_distances_to_line(begin, end, point, { points.x[index], points.y[index] }, side) > 0)
+        {
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+void get_sides_simd(frm::Point begin, frm::Point end, PointSpan points, SideByLine * sides) noexcept
+{
+    size_t i = 0;
+
+    for (; i + simd_width <= points.size; i += simd_width)
+    {
+        __m128 left_products;
+        __m128 right_products;
+        get_cross_product_terms_simd(begin, end, points, i, left_products, right_products);
+
+        __m128 is_positive;
+        __m128 is_negative;
+        get_cross_product_signs_simd(begin, end, points, i, left_products, right_products, is_positive, is_negative);
+
+        int const right_mask = _mm_movemask_ps(is_positive);
+        int const left_mask = _mm_movemask_ps(is_negative);
+
+        for (size_t lane = 0; lane < simd_width; ++lane)
+        {
+            sides[i + lane] = (right_mask >> lane) & 1 ? SideByLine::Right :
+                (left_mask >> lane) & 1 ? SideByLine::Left : SideByLine::OnLine;
+        }
+    }
+
+    for (; i < points.size; ++i)
+    {
+        sides[i] = get_side(begin, end, { points.x[i], points.y[i] });
+    }
+}
+
+void get_distances_to_line_simd(frm::Point begin, frm::Point end, PointSpan points, float * distances) noexcept
+{
+    size_t i = 0;
+
+    for (; i + simd_width <= points.size; i += simd_width)
+    {
+        __m128 left_products;
+        __m128 right_products;
+        get_cross_product_terms_simd(begin, end, points, i, left_products, right_products);
+
+        _mm_storeu_ps(distances + i, get_abs_simd(_mm_sub_ps(left_products, right_products)));
+    }
+
+    for (; i < points.size; ++i)
+    {
+        distances[i] = distance_to_line(begin, end, { points.x[i], points.y[i] });
+    }
+}
+
+size_t get_farthest_point_on_side_simd(frm::Point begin, frm::Point end, PointSpan points, SideByLine side) noexcept
+{
+    if (side == SideByLine::OnLine)
+    {
+        return get_farthest_point_on_side(begin, end, points, side);
+    }
+
+    // every lane keeps the first of its farthest points
+    // float distances with doubled error bounds decide which point is farther, close distances are compared exactly
+    // distances are signed, so points on other side are rejected together with points closer than the farthest one
+    __m128 const error_bound_factor = _mm_set1_ps(2.f * cross_product_relative_error_bound);
+    __m128 max_distances = _mm_setzero_ps();
+    __m128 max_distance_errors = _mm_setzero_ps();
+    __m128i max_indices = _mm_set1_epi32(-1);
+    __m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i const step = _mm_set1_epi32(static_cast<int>(simd_width));
+
+    size_t i = 0;
+
+    for (; i + simd_width <= points.size; i += simd_width)
+    {
+        __m128i const current_indices = indices;
+        indices = _mm_add_epi32(indices, step);
+
+        __m128 left_products;
+        __m128 right_products;
+        get_cross_product_terms_simd(begin, end, points, i, left_products, right_products);
+
+        __m128 const distances = side == SideByLine::Right ?
+            _mm_sub_ps(left_products, right_products) :
+            _mm_sub_ps(right_products, left_products);
+        __m128 const distance_errors = _mm_mul_ps(
+            error_bound_factor,
+            _mm_add_ps(get_abs_simd(left_products), get_abs_simd(right_products))
+        );
+
+        __m128 const may_be_farther = _mm_cmpgt_ps(
+            _mm_add_ps(distances, distance_errors),
+            _mm_sub_ps(max_distances, max_distance_errors)
+        );
+
+        if (_mm_movemask_ps(may_be_farther) == 0)
+        {
+            continue;
+        }
+
+        __m128 is_positive;
+        __m128 is_negative;
+        get_cross_product_signs_simd(begin, end, points, i, left_products, right_products, is_positive, is_negative);
+
+        __m128 const is_on_side = side == SideByLine::Right ? is_positive : is_negative;
+        __m128 const has_max = _mm_castsi128_ps(_mm_cmpgt_epi32(max_indices, _mm_set1_epi32(-1)));
+
+        __m128 const is_surely_farther = _mm_cmpgt_ps(
+            _mm_sub_ps(distances, distance_errors),
+            _mm_add_ps(max_distances, max_distance_errors)
+        );
+
+        __m128 const is_farther = _mm_or_ps(_mm_andnot_ps(has_max, is_on_side), _mm_and_ps(is_on_side, is_surely_farther));
+        __m128 const is_unknown = _mm_andnot_ps(is_surely_farther, _mm_and_ps(_mm_and_ps(is_on_side, has_max), may_be_farther));
+
+        max_distances = _mm_or_ps(_mm_and_ps(is_farther, distances), _mm_andnot_ps(is_farther, max_distances));
+        max_distance_errors = _mm_or_ps(_mm_and_ps(is_farther, distance_errors), _mm_andnot_ps(is_farther, max_distance_errors));
+
+        __m128i const is_farther_integer = _mm_castps_si128(is_farther);
+        max_indices = _mm_or_si128(_mm_and_si128(is_farther_integer, current_indices), _mm_andnot_si128(is_farther_integer, max_indices));
+
+        int const is_unknown_mask = _mm_movemask_ps(is_unknown);
+
+        if (is_unknown_mask == 0)
+        {
+            continue;
+        }
+
+        alignas(16) float lane_distances[simd_width];
+        alignas(16) float lane_distance_errors[simd_width];
+        alignas(16) int32_t lane_indices[simd_width];
+        alignas(16) float current_distances[simd_width];
+        alignas(16) float current_distance_errors[simd_width];
+        _mm_store_ps(lane_distances, max_distances);
+        _mm_store_ps(lane_distance_errors, max_distance_errors);
+        _mm_store_si128(reinterpret_cast<__m128i *>(lane_indices), max_indices);
+        _mm_store_ps(current_distances, distances);
+        _mm_store_ps(current_distance_errors, distance_errors);
+
+        for (size_t lane = 0; lane < simd_width; ++lane)
+        {
+            if (((is_unknown_mask >> lane) & 1) == 0)
+            {
+                continue;
+            }
+
+            size_t const index = i + lane;
+            size_t const max_index = static_cast<size_t>(lane_indices[lane]);
+
+            if (compare_distances_to_line(begin, end,
+                { points.x[index], points.y[index] }, { points.x[max_index], points.y[max_index] }, side) > 0)
+            {
+                lane_distances[lane] = current_distances[lane];
+                lane_distance_errors[lane] = current_distance_errors[lane];
+                lane_indices[lane] = static_cast<int32_t>(index);
+            }
+        }
+
+        max_distances = _mm_load_ps(lane_distances);
+        max_distance_errors = _mm_load_ps(lane_distance_errors);
+        max_indices = _mm_load_si128(reinterpret_cast<__m128i const *>(lane_indices));
+    }
+
+    alignas(16) int32_t lane_indices[simd_width];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lane_indices), max_indices);
+
+    // the farthest of lanes and the rest points, the first point if distances are equal
+    size_t index = points.size;
+
+    auto const add_candidate = [&begin, &end, &points, &index, side](size_t candidate) noexcept
+    {
+        if (index == points.size)
+        {
+            index = candidate;
+            return;
+        }
+
+        int const comparison = compare_distances_to_line(begin, end,
+            { points.x[candidate], points.y[candidate] }, { points.x[index], points.y[index] }, side);
+
+        if (comparison > 0 || (comparison == 0 && candidate < index))
+        {
+            index = candidate;
+        }
+    };
+
+    for (size_t lane = 0; lane < simd_width; ++lane)
+    {
+        if (lane_indices[lane] >= 0)
+        {
+            add_candidate(static_cast<size_t>(lane_indices[lane]));
+        }
+    }
+
+    for (; i < points.size; ++i)
+    {
+        if (get_side(begin, end, { points.x[i], points.y[i] }) == side)
+        {
+            add_candidate(i);
+        }
+    }
+
+    return index;
+}
\ No newline at end of file
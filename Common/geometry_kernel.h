@@ -0,0 +1,200 @@
+#pragma once
+
+
+#include "vvve.h"
+
+#include <cstdint>
+#include <cmath>
+#include <xmmintrin.h>
+
+
+// side of point by directed line, with y axis going down as in window positive cross product is on the right
+enum class SideByLine : uint8_t
+{
+    Left,
+    Right,
+    OnLine
+};
+
+// turn from p to q to r with y axis going up
+enum class Orientation : uint8_t
+{
+    Counterclockwise,
+    Clockwise,
+    Colinear
+};
+
+// structure of arrays, x and y have size elements
+struct PointSpan
+{
+    float const * x;
+    float const * y;
+    size_t size;
+};
+
+
+// twice signed area of triangle begin, end, point
+inline float get_cross_product(frm::Point begin, frm::Point end, frm::Point point) noexcept
+{
+    return (end.x - begin.x) * (point.y - begin.y) - (end.y - begin.y) * (point.x - begin.x);
+}
+
+// bound of rounding error of float cross product relative to sum of absolute values of its two products
+// from Shewchuk's "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates",
+// (3 + 16 * e) * e where e = 2^-24 is half of float ulp, underflow of products is not taken into account
+float constexpr cross_product_relative_error_bound = (3.f + 16.f / 16777216.f) / 16777216.f;
+
+// sign of cross product of vectors first_end - first_begin and second_end - second_begin, -1, 0 or 1
+// computed with exact arithmetic on doubles
+int get_exact_cross_product_sign(frm::Point first_begin, frm::Point first_end, frm::Point second_begin, frm::Point second_end) noexcept;
+
+// the same sign without rounding errors
+// float result is used when error bound proves its sign, that is almost always, exact arithmetic otherwise
+inline int get_cross_product_sign(frm::Point first_begin, frm::Point first_end, frm::Point second_begin, frm::Point second_end) noexcept
+{
+    float const left_product = (first_end.x - first_begin.x) * (second_end.y - second_begin.y);
+    float const right_product = (first_end.y - first_begin.y) * (second_end.x - second_begin.x);
+    float const cross_product = left_product - right_product;
+
+    float const error_bound = cross_product_relative_error_bound * (std::abs(left_product) + std::abs(right_product));
+
+    if (cross_product > error_bound)
+    {
+        return 1;
+    }
+    if (-cross_product > error_bound)
+    {
+        return -1;
+    }
+
+    // both products have zero factor or vectors are the same, for example when points are equal
+    if ((first_end.x == first_begin.x || second_end.y == second_begin.y) &&
+        (first_end.y == first_begin.y || second_end.x == second_begin.x))
+    {
+        return 0;
+    }
+    if (first_begin.x == second_begin.x && first_begin.y == second_begin.y &&
+        first_end.x == second_end.x && first_end.y == second_end.y)
+    {
+        return 0;
+    }
+
+    return get_exact_cross_product_sign(first_begin, first_end, second_begin, second_end);
+}
+
+// sign of get_cross_product without rounding errors
+inline int get_cross_product_sign(frm::Point begin, frm::Point end, frm::Point point) noexcept
+{
+    return get_cross_product_sign(begin, end, begin, point);
+}
+
+// point is on line only if it is exactly on line
+inline SideByLine get_side(frm::Point begin, frm::Point end, frm::Point point) noexcept
+{
+    int const sign = get_cross_product_sign(begin, end, point);
+
+    if (sign == 0)
+    {
+        return SideByLine::OnLine;
+    }
+
+    return sign > 0 ? SideByLine::Right : SideByLine::Left;
+}
+
+constexpr SideByLine invert_side(SideByLine side) noexcept
+{
+    return (side == SideByLine::OnLine ? SideByLine::OnLine : (
+        side == SideByLine::Left ? SideByLine::Right : SideByLine::Left
+        ));
+}
+
+inline Orientation get_orientation(frm::Point p, frm::Point q, frm::Point r) noexcept
+{
+    int const sign = get_cross_product_sign(p, q, r);
+
+    if (sign == 0)
+    {
+        return Orientation::Colinear;
+    }
+
+    return sign > 0 ? Orientation::Counterclockwise : Orientation::Clockwise;
+}
+
+// distance multiplied by length of line, enough to compare distances to one line
+inline float distance_to_line(frm::Point begin, frm::Point end, frm::Point point) noexcept
+{
+    return std::abs(get_cross_product(begin, end, point));
+}
+
+
+// the same as scalar functions for every point
+void get_sides(frm::Point begin, frm::Point end, PointSpan points, SideByLine * sides) noexcept;
+void get_distances_to_line(frm::Point begin, frm::Point end, PointSpan points, float * distances) noexcept;
+
+// the first of the farthest points on side of line, points.size if there is no point on side
+// distances are compared without rounding errors, so the point is vertex of convex hull or lies on its edge
+size_t get_farthest_point_on_side(frm::Point begin, frm::Point end, PointSpan points, SideByLine side) noexcept;
+
+// SSE versions give the same results as scalar ones, four points go together and the rest is processed by scalar code
+// points.size < 2^31
+void get_sides_simd(frm::Point begin, frm::Point end, PointSpan points, SideByLine * sides) noexcept;
+void get_distances_to_line_simd(frm::Point begin, frm::Point end, PointSpan points, float * distances) noexcept;
+size_t get_farthest_point_on_side_simd(frm::Point begin, frm::Point end, PointSpan points, SideByLine side) noexcept;
+
+
+// operations on one float or on four floats of SSE register
+// predicates which are written with them give the same results in scalar and SSE code
+inline float add_lanes(float first, float second) noexcept
+{
+    return first + second;
+}
+
+inline __m128 add_lanes(__m128 first, __m128 second) noexcept
+{
+    return _mm_add_ps(first, second);
+}
+
+inline float subtract_lanes(float first, float second) noexcept
+{
+    return first - second;
+}
+
+inline __m128 subtract_lanes(__m128 first, __m128 second) noexcept
+{
+    return _mm_sub_ps(first, second);
+}
+
+inline float multiply_lanes(float first, float second) noexcept
+{
+    return first * second;
+}
+
+inline __m128 multiply_lanes(__m128 first, __m128 second) noexcept
+{
+    return _mm_mul_ps(first, second);
+}
+
+inline bool is_greater_lanes(float first, float second) noexcept
+{
+    return first > second;
+}
+
+// all bits of lane are set if comparison is true
+inline __m128 is_greater_lanes(__m128 first, __m128 second) noexcept
+{
+    return _mm_cmpgt_ps(first, second);
+}
+
+// point x, y is over line y = k * x + c, the same test as frm::is_point_over_line
+template<typename Lanes>
+auto is_over_line(Lanes x, Lanes y, Lanes k, Lanes c) noexcept
+{
+    return is_greater_lanes(y, add_lanes(multiply_lanes(k, x), c));
+}
+
+// x is to the right of vertical line at line_x, x which is closer than epsilon is not to the right
+template<typename Lanes>
+auto is_right_of_vertical_line(Lanes x, Lanes line_x, Lanes epsilon) noexcept
+{
+    return is_greater_lanes(subtract_lanes(x, line_x), epsilon);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+bool map_file_for_reading(std::string const & file_name, void const * & data, size_t & size) noexcept
+{
+#ifdef _WIN32
+    HANDLE const file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    size = static_cast<size_t>(file_size.QuadPart);
+
+    return data != nullptr;
+#else
+    int const file = open(file_name.c_str(), O_RDONLY);
+
+    if (file == -1)
+    {
+        return false;
+    }
+
+    struct stat file_status{};
+    if (fstat(file, &file_status) == -1 || file_status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    size = static_cast<size_t>(file_status.st_size);
+
+    void * const mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    data = mapping;
+
+    return true;
+#endif
+}
+
+void unmap_file(void const * data, size_t size) noexcept
+{
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<void *>(data), size);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+
+#include <string>
+
+
+// read-only mapping of whole file, file handles are closed after mapping, mapping keeps file alive
+// returns false if file is absent or empty
+bool map_file_for_reading(std::string const & file_name, void const * & data, size_t & size) noexcept;
+
+void unmap_file(void const * data, size_t size) noexcept;
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+
+#include "dcel.h"
+
+#include <memory>
+#include <future>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+
+
+// FNV-1a over geometry and topology, equal dcels have equal hashes
+inline size_t get_dcel_hash(frm::dcel::DCEL const & dcel) noexcept
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    auto const add_to_hash = [&hash](uint64_t value) noexcept
+    {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    auto const get_float_bits = [](float value) noexcept -> uint32_t
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+
+    add_to_hash(dcel.vertices.size());
+    for (size_t i = 0; i < dcel.vertices.size(); ++i)
+    {
+        frm::Point const point = dcel.vertices[i].coordinate;
+        add_to_hash((static_cast<uint64_t>(get_float_bits(point.x)) << 32) | get_float_bits(point.y));
+    }
+
+    add_to_hash(dcel.edges.size());
+    for (size_t i = 0; i < dcel.edges.size(); ++i)
+    {
+        add_to_hash(dcel.edges[i].origin_vertex);
+        add_to_hash(dcel.edges[i].twin_edge);
+        add_to_hash(dcel.edges[i].incident_face);
+        add_to_hash(dcel.edges[i].next_edge);
+    }
+
+    add_to_hash(dcel.faces.size());
+
+    return static_cast<size_t>(hash);
+}
+
+
+// published point location structure, it is never changed
+template <typename Structure>
+struct PointLocationSnapshot
+{
+    Structure structure;
+
+    // number of snapshots published before this one
+    size_t version;
+    size_t dcel_hash;
+};
+
+// point location structure which is rebuilt only after dcel is changed
+// rebuild runs on other thread and publishes new snapshot itself, readers are never blocked by it
+// cache must not be moved while rebuild is running
+template <typename Structure>
+struct PointLocationCache
+{
+    // read and replaced only by std::atomic_load and std::atomic_store
+    // reader keeps its copy, previous snapshot is destroyed when its last reader releases it
+    std::shared_ptr<PointLocationSnapshot<Structure> const> snapshot;
+
+    std::future<void> rebuild;
+    size_t next_dcel_hash;
+};
+
+
+template <typename Generator>
+auto create_point_location_cache(frm::dcel::DCEL const & dcel, Generator generator) noexcept(!IS_DEBUG)
+    -> PointLocationCache<std::invoke_result_t<Generator, frm::dcel::DCEL const &>>
+{
+    using structure_t = std::invoke_result_t<Generator, frm::dcel::DCEL const &>;
+
+    PointLocationCache<structure_t> cache{};
+
+    size_t const dcel_hash = get_dcel_hash(dcel);
+
+    cache.snapshot = std::make_shared<PointLocationSnapshot<structure_t> const>(PointLocationSnapshot<structure_t>{ generator(dcel), 0, dcel_hash });
+    cache.next_dcel_hash = dcel_hash;
+
+    return cache;
+}
+
+// O(1), snapshot stays valid while it is held, even if newer one is published
+template <typename Structure>
+std::shared_ptr<PointLocationSnapshot<Structure> const> get_point_location_snapshot(PointLocationCache<Structure> const & cache) noexcept
+{
+    return std::atomic_load(&cache.snapshot);
+}
+
+// O(n) if dcel is not changed
+// true if rebuild has finished since previous call, its snapshot is already published
+template <typename Structure, typename Generator>
+bool update_point_location_cache(PointLocationCache<Structure> & cache, frm::dcel::DCEL const & dcel, Generator generator) noexcept(!IS_DEBUG)
+{
+    bool is_published = false;
+
+    if (cache.rebuild.valid() && cache.rebuild.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready)
+    {
+        cache.rebuild.get();
+        is_published = true;
+    }
+
+    size_t const dcel_hash = get_dcel_hash(dcel);
+
+    // only one rebuild at a time, next one is started after current is published
+    if (dcel_hash != cache.next_dcel_hash && !cache.rebuild.valid())
+    {
+        size_t const version = get_point_location_snapshot(cache)->version + 1;
+
+        cache.next_dcel_hash = dcel_hash;
+        cache.rebuild = std::async(std::launch::async, [&cache, generator, dcel, dcel_hash, version]()
+            {
+                std::shared_ptr<PointLocationSnapshot<Structure> const> const snapshot =
+                    std::make_shared<PointLocationSnapshot<Structure> const>(PointLocationSnapshot<Structure>{ generator(dcel), version, dcel_hash });
+
+                std::atomic_store(&cache.snapshot, snapshot);
+            });
+    }
+
+    return is_published;
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+// binary protocol of point location server over unix domain socket
+// every request is header and points_count points (two floats), every response is header and faces_count faces (uint32_t)
+// numbers are stored in native byte order, client and server run on one machine
+
+uint32_t constexpr point_location_protocol_magic = 0x4c4f4350; // "PCOL"
+uint32_t constexpr max_points_in_point_location_request = 1u << 20;
+
+enum class PointLocationRequestType : uint32_t
+{
+    // version and bounding box of current index
+    GetInfo,
+    // face of every point, points outside bounding box are in outside face
+    GetFaceIndices,
+    // index is built again from file, requests of other connections are answered by previous index meanwhile
+    Rebuild
+};
+
+enum class PointLocationResponseStatus : uint32_t
+{
+    Ok,
+    BadRequest,
+    RebuildFailed
+};
+
+struct PointLocationRequestHeader
+{
+    uint32_t magic;
+    PointLocationRequestType type;
+    uint32_t points_count;
+    uint32_t reserved;
+};
+
+struct PointLocationResponseHeader
+{
+    uint32_t magic;
+    PointLocationResponseStatus status;
+    // version of index which answered request
+    uint32_t index_version;
+    uint32_t faces_count;
+
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+};
+
+static_assert(sizeof(PointLocationRequestHeader) == 16, "header is part of protocol");
+static_assert(sizeof(PointLocationResponseHeader) == 32, "header is part of protocol");
+
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+socket_t constexpr invalid_socket = INVALID_SOCKET;
+#else
+using socket_t = int;
+socket_t constexpr invalid_socket = -1;
+#endif
+
+
+// must be called once before other socket functions
+inline bool initialize_sockets() noexcept
+{
+#ifdef _WIN32
+    WSADATA data{};
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+inline void close_socket(socket_t socket) noexcept
+{
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+inline bool fill_unix_socket_address(std::string const & path, sockaddr_un & address) noexcept
+{
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    return true;
+}
+
+// previous socket file is removed
+inline socket_t create_listening_socket(std::string const & path) noexcept
+{
+    sockaddr_un address{};
+
+    if (!fill_unix_socket_address(path, address))
+    {
+        return invalid_socket;
+    }
+
+    socket_t const listening_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listening_socket == invalid_socket)
+    {
+        return invalid_socket;
+    }
+
+    std::remove(path.c_str());
+
+    if (bind(listening_socket, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0 ||
+        listen(listening_socket, SOMAXCONN) != 0)
+    {
+        close_socket(listening_socket);
+        return invalid_socket;
+    }
+
+    return listening_socket;
+}
+
+inline socket_t connect_to_socket(std::string const & path) noexcept
+{
+    sockaddr_un address{};
+
+    if (!fill_unix_socket_address(path, address))
+    {
+        return invalid_socket;
+    }
+
+    socket_t const connected_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connected_socket == invalid_socket)
+    {
+        return invalid_socket;
+    }
+
+    if (connect(connected_socket, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0)
+    {
+        close_socket(connected_socket);
+        return invalid_socket;
+    }
+
+    return connected_socket;
+}
+
+// false if connection is closed
+inline bool send_all(socket_t socket, void const * data, size_t size) noexcept
+{
+    char const * bytes = static_cast<char const *>(data);
+
+#ifdef MSG_NOSIGNAL
+    int constexpr flags = MSG_NOSIGNAL;
+#else
+    int constexpr flags = 0;
+#endif
+
+    while (size != 0)
+    {
+        int const part_size = static_cast<int>(size < (1u << 30) ? size : (1u << 30));
+        auto const sent_size = send(socket, bytes, part_size, flags);
+
+        if (sent_size <= 0)
+        {
+            return false;
+        }
+
+        bytes += sent_size;
+        size -= static_cast<size_t>(sent_size);
+    }
+
+    return true;
+}
+
+// false if connection is closed before size bytes are received
+inline bool receive_all(socket_t socket, void * data, size_t size) noexcept
+{
+    char * bytes = static_cast<char *>(data);
+
+    while (size != 0)
+    {
+        int const part_size = static_cast<int>(size < (1u << 30) ? size : (1u << 30));
+        auto const received_size = recv(socket, bytes, part_size, 0);
+
+        if (received_size <= 0)
+        {
+            return false;
+        }
+
+        bytes += received_size;
+        size -= static_cast<size_t>(received_size);
+    }
+
+    return true;
+}
\ No newline at end of file
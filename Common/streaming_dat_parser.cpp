@@ -0,0 +1,893 @@
+#include "streaming_dat_parser.h"
+#include "mapped_file.h"
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <limits>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <fstream>
+#include <condition_variable>
+
+
+size_t constexpr max_waiting_dat_batches_count = 2;
+
+
+// numbers of record, flags are the last numbers of record
+struct DatSectionFormat
+{
+    DatSection section;
+    size_t floats_count;
+    size_t indices_count;
+    size_t flags_count;
+};
+
+struct DatTokenReader
+{
+    std::ifstream file;
+    std::vector<char> buffer;
+
+    // unread part of buffer
+    size_t begin{ 0 };
+    size_t end{ 0 };
+
+    bool is_file_ended{ false };
+};
+
+struct DatMemoryReader
+{
+    char const * current;
+    char const * end;
+};
+
+// filled batches wait for consumer, consumed batches are reused by parser
+struct DatBatchQueue
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::deque<DatBatch> waiting_batches;
+    std::vector<DatBatch> free_batches;
+
+    bool is_parsing_finished{ false };
+};
+
+// part of vertex section which is parsed by one thread
+struct DatVertexChunk
+{
+    char const * first_record;
+    size_t first_index;
+    size_t records_count;
+
+    // position after the last record of chunk
+    char const * records_end;
+    bool is_parsed;
+};
+
+
+bool parse_dat_float(char const * begin, char const * end, float & value) noexcept
+{
+    double constexpr powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    int constexpr max_significant_digits_count = 19;
+
+    char const * current = begin;
+
+    bool const is_negative = current != end && *current == '-';
+    if (current != end && (*current == '-' || *current == '+'))
+    {
+        ++current;
+    }
+
+    uint64_t mantissa = 0;
+    int significant_digits_count = 0;
+    int exponent = 0;
+    bool has_digits = false;
+
+    auto const add_digit = [&](char digit, bool is_fraction) noexcept
+    {
+        has_digits = true;
+
+        if (significant_digits_count < max_significant_digits_count)
+        {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(digit - '0');
+            // leading zeros are not significant
+            significant_digits_count += mantissa != 0;
+            exponent -= is_fraction;
+        }
+        else
+        {
+            exponent += !is_fraction;
+        }
+    };
+
+    while (current != end && *current >= '0' && *current <= '9')
+    {
+        add_digit(*current++, false);
+    }
+
+    if (current != end && *current == '.')
+    {
+        ++current;
+
+        while (current != end && *current >= '0' && *current <= '9')
+        {
+            add_digit(*current++, true);
+        }
+    }
+
+    if (!has_digits)
+    {
+        return false;
+    }
+
+    if (current != end && (*current == 'e' || *current == 'E'))
+    {
+        ++current;
+
+        bool const is_exponent_negative = current != end && *current == '-';
+        if (current != end && (*current == '-' || *current == '+'))
+        {
+            ++current;
+        }
+
+        if (current == end)
+        {
+            return false;
+        }
+
+        int written_exponent = 0;
+        while (current != end && *current >= '0' && *current <= '9')
+        {
+            // larger exponents give zero or infinity anyway
+            written_exponent = std::min(written_exponent * 10 + (*current++ - '0'), 1000);
+        }
+
+        exponent += is_exponent_negative ? -written_exponent : written_exponent;
+    }
+
+    if (current != end)
+    {
+        return false;
+    }
+
+    // exact for up to 15 digits and |exponent| <= 22, the most common case
+    double result = static_cast<double>(mantissa);
+
+    for (; exponent > 22 && result != 0.; exponent -= 22)
+    {
+        result *= powers_of_ten[22];
+    }
+    for (; exponent < -22 && result != 0.; exponent += 22)
+    {
+        result /= powers_of_ten[22];
+    }
+
+    if (exponent >= 0)
+    {
+        result *= powers_of_ten[std::min(exponent, 22)];
+    }
+    else
+    {
+        result /= powers_of_ten[std::min(-exponent, 22)];
+    }
+
+    value = static_cast<float>(is_negative ? -result : result);
+
+    return true;
+}
+
+bool parse_dat_index(char const * begin, char const * end, size_t & value) noexcept
+{
+    if (begin == end)
+    {
+        return false;
+    }
+
+    size_t result = 0;
+
+    for (char const * current = begin; current != end; ++current)
+    {
+        if (*current < '0' || *current > '9')
+        {
+            return false;
+        }
+
+        size_t const digit = static_cast<size_t>(*current - '0');
+
+        if (result > (std::numeric_limits<size_t>::max() - digit) / 10)
+        {
+            return false;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    value = result;
+
+    return true;
+}
+
+bool is_dat_separator(char symbol) noexcept
+{
+    return symbol == ' ' || symbol == '\n' || symbol == '\r' || symbol == '\t' ||
+        symbol == '[' || symbol == ']' || symbol == ',' || symbol == '{' || symbol == '}';
+}
+
+// numbers are tokens between brackets, commas and spaces
+// false at end of file or if token does not fit in buffer
+bool read_dat_token(DatTokenReader & reader, char const * & token_begin, char const * & token_end) noexcept
+{
+    while (true)
+    {
+        while (reader.begin != reader.end && is_dat_separator(reader.buffer[reader.begin]))
+        {
+            ++reader.begin;
+        }
+
+        size_t token_size = 0;
+        while (reader.begin + token_size != reader.end && !is_dat_separator(reader.buffer[reader.begin + token_size]))
+        {
+            ++token_size;
+        }
+
+        // token which touches end of buffer may go on in next block
+        bool const is_token_complete = reader.begin + token_size != reader.end || reader.is_file_ended;
+
+        if (token_size != 0 && is_token_complete)
+        {
+            token_begin = reader.buffer.data() + reader.begin;
+            token_end = token_begin + token_size;
+            reader.begin += token_size;
+
+            return true;
+        }
+
+        if (reader.is_file_ended || token_size == reader.buffer.size())
+        {
+            return false;
+        }
+
+        std::memmove(reader.buffer.data(), reader.buffer.data() + reader.begin, token_size);
+        reader.begin = 0;
+        reader.end = token_size;
+
+        reader.file.read(reader.buffer.data() + reader.end, static_cast<std::streamsize>(reader.buffer.size() - reader.end));
+
+        size_t const read_size = static_cast<size_t>(reader.file.gcount());
+        reader.end += read_size;
+        reader.is_file_ended = read_size == 0;
+    }
+}
+
+bool read_dat_token(DatMemoryReader & reader, char const * & token_begin, char const * & token_end) noexcept
+{
+    while (reader.current != reader.end && is_dat_separator(*reader.current))
+    {
+        ++reader.current;
+    }
+
+    token_begin = reader.current;
+
+    while (reader.current != reader.end && !is_dat_separator(*reader.current))
+    {
+        ++reader.current;
+    }
+
+    token_end = reader.current;
+
+    return token_begin != token_end;
+}
+
+template <typename Reader>
+bool read_dat_index(Reader & reader, size_t & value) noexcept
+{
+    char const * token_begin;
+    char const * token_end;
+
+    return read_dat_token(reader, token_begin, token_end) && parse_dat_index(token_begin, token_end, value);
+}
+
+template <typename Reader>
+bool read_dat_float(Reader & reader, float & value) noexcept
+{
+    char const * token_begin;
+    char const * token_end;
+
+    return read_dat_token(reader, token_begin, token_end) && parse_dat_float(token_begin, token_end, value);
+}
+
+DatBatch get_free_dat_batch(DatBatchQueue & queue) noexcept(!IS_DEBUG)
+{
+    std::lock_guard<std::mutex> const lock{ queue.mutex };
+
+    if (queue.free_batches.empty())
+    {
+        return DatBatch{};
+    }
+
+    DatBatch batch = std::move(queue.free_batches.back());
+    queue.free_batches.pop_back();
+
+    return batch;
+}
+
+void push_dat_batch(DatBatchQueue & queue, DatBatch && batch) noexcept(!IS_DEBUG)
+{
+    std::unique_lock<std::mutex> lock{ queue.mutex };
+
+    queue.condition.wait(lock, [&queue]() noexcept
+        {
+            return queue.waiting_batches.size() < max_waiting_dat_batches_count;
+        });
+
+    queue.waiting_batches.push_back(std::move(batch));
+    queue.condition.notify_all();
+}
+
+// sections from first_section are parsed in order, batch is given to handle_batch when it is filled
+// handle_batch may replace batch by other object
+template <typename Reader, typename BatchHandler>
+bool parse_dat_sections(
+    Reader & reader,
+    GeometryFileType type,
+    size_t first_section,
+    size_t batch_size,
+    DatBatch & batch,
+    BatchHandler const & handle_batch
+) noexcept(!IS_DEBUG)
+{
+    DatSectionFormat constexpr vvve_sections[] = {
+        { DatSection::Vertices, 2, 0, 0 },
+        { DatSection::Edges, 0, 2, 0 }
+    };
+    DatSectionFormat constexpr dcel_sections[] = {
+        { DatSection::Vertices, 2, 1, 1 },
+        { DatSection::Faces, 0, 1, 1 },
+        { DatSection::Edges, 0, 5, 1 },
+        { DatSection::FreeVertices, 0, 1, 0 },
+        { DatSection::FreeFaces, 0, 1, 0 },
+        { DatSection::FreeEdges, 0, 1, 0 }
+    };
+
+    DatSectionFormat const * const sections = type == GeometryFileType::Vvve ? vvve_sections : dcel_sections;
+    size_t const sections_count = type == GeometryFileType::Vvve ? std::size(vvve_sections) : std::size(dcel_sections);
+
+    for (size_t i = first_section; i < sections_count; ++i)
+    {
+        DatSectionFormat const & format = sections[i];
+
+        size_t section_size;
+        if (!read_dat_index(reader, section_size))
+        {
+            return false;
+        }
+
+        for (size_t first_index = 0; first_index < section_size; first_index += batch_size)
+        {
+            batch.section = format.section;
+            batch.first_index = first_index;
+            batch.section_size = section_size;
+            batch.records_count = std::min(batch_size, section_size - first_index);
+            batch.indices_per_record = format.indices_count;
+
+            batch.coordinates.resize(format.floats_count == 0 ? 0 : batch.records_count);
+            batch.indices.resize(batch.records_count * format.indices_count);
+            batch.flags.resize(batch.records_count * format.flags_count);
+
+            size_t current_index = 0;
+            size_t current_flag = 0;
+
+            for (size_t record = 0; record < batch.records_count; ++record)
+            {
+                if (format.floats_count != 0)
+                {
+                    frm::Point & coordinate = batch.coordinates[record];
+
+                    if (!read_dat_float(reader, coordinate.x) || !read_dat_float(reader, coordinate.y))
+                    {
+                        return false;
+                    }
+                }
+
+                for (size_t j = 0; j < format.indices_count; ++j)
+                {
+                    if (!read_dat_index(reader, batch.indices[current_index++]))
+                    {
+                        return false;
+                    }
+                }
+
+                for (size_t j = 0; j < format.flags_count; ++j)
+                {
+                    if (!read_dat_index(reader, batch.flags[current_flag++]))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            handle_batch(batch);
+        }
+    }
+
+    return true;
+}
+
+bool parse_dat_file(
+    std::string const & file_name,
+    GeometryFileType type,
+    dat_batch_consumer_t const & consumer,
+    size_t block_size,
+    size_t batch_size
+) noexcept(!IS_DEBUG)
+{
+    DatTokenReader reader{};
+    reader.file.open(file_name, std::ios::binary);
+
+    if (!reader.file)
+    {
+        return false;
+    }
+
+    // the longest token must fit in block
+    reader.buffer.resize(std::max(block_size, size_t{ 256 }));
+    batch_size = std::max(batch_size, size_t{ 1 });
+
+    DatBatchQueue queue{};
+    bool is_parsed = false;
+
+    std::thread parser([&reader, type, batch_size, &queue, &is_parsed]() noexcept(!IS_DEBUG)
+        {
+            DatBatch batch = get_free_dat_batch(queue);
+
+            bool const result = parse_dat_sections(reader, type, 0, batch_size, batch, [&queue](DatBatch & filled_batch) noexcept(!IS_DEBUG)
+                {
+                    push_dat_batch(queue, std::move(filled_batch));
+                    filled_batch = get_free_dat_batch(queue);
+                });
+
+            std::lock_guard<std::mutex> const lock{ queue.mutex };
+            is_parsed = result;
+            queue.is_parsing_finished = true;
+            queue.condition.notify_all();
+        });
+
+    while (true)
+    {
+        DatBatch batch{};
+
+        {
+            std::unique_lock<std::mutex> lock{ queue.mutex };
+
+            queue.condition.wait(lock, [&queue]() noexcept
+                {
+                    return !queue.waiting_batches.empty() || queue.is_parsing_finished;
+                });
+
+            if (queue.waiting_batches.empty())
+            {
+                break;
+            }
+
+            batch = std::move(queue.waiting_batches.front());
+            queue.waiting_batches.pop_front();
+            queue.condition.notify_all();
+        }
+
+        consumer(batch);
+
+        std::lock_guard<std::mutex> const lock{ queue.mutex };
+        queue.free_batches.push_back(std::move(batch));
+    }
+
+    parser.join();
+
+    return is_parsed;
+}
+
+// outer bracket of vertex record is followed by bracket of coordinate, records of other sections have one bracket
+bool is_dat_vertex_record_begin(char const * current, char const * file_end) noexcept
+{
+    if (*current != '[')
+    {
+        return false;
+    }
+
+    for (++current; current != file_end; ++current)
+    {
+        if (*current != ' ' && *current != '\n' && *current != '\r' && *current != '\t')
+        {
+            return *current == '[';
+        }
+    }
+
+    return false;
+}
+
+// the first vertex record which begins in [begin, end) or end
+char const * find_dat_vertex_record(char const * begin, char const * end, char const * file_end) noexcept
+{
+    for (char const * current = begin; current != end; ++current)
+    {
+        current = static_cast<char const *>(std::memchr(current, '[', static_cast<size_t>(end - current)));
+
+        if (current == nullptr)
+        {
+            return end;
+        }
+
+        if (is_dat_vertex_record_begin(current, file_end))
+        {
+            return current;
+        }
+    }
+
+    return end;
+}
+
+// function(i) is called for every i < count, i = 0 is handled on calling thread
+template <typename Function>
+void run_dat_chunks_in_parallel(size_t count, Function const & function) noexcept(!IS_DEBUG)
+{
+    std::vector<std::thread> threads{};
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        threads.emplace_back(function, i);
+    }
+    function(0);
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// vertices are written by set_vertex(index, coordinate, edge) to array of vertices_count elements prepared by resize_vertices
+// other sections are given to consumer in order
+template <typename ResizeVertices, typename SetVertex>
+bool parse_dat_file_in_parallel(
+    std::string const & file_name,
+    GeometryFileType type,
+    size_t threads_count,
+    ResizeVertices const & resize_vertices,
+    SetVertex const & set_vertex,
+    dat_batch_consumer_t const & consumer
+) noexcept(!IS_DEBUG)
+{
+    void const * data = nullptr;
+    size_t size = 0;
+
+    if (!map_file_for_reading(file_name, data, size))
+    {
+        return false;
+    }
+
+    char const * const file_begin = static_cast<char const *>(data);
+    char const * const file_end = file_begin + size;
+
+    if (threads_count == 0)
+    {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    DatMemoryReader reader{ file_begin, file_end };
+
+    size_t vertices_count;
+    if (!read_dat_index(reader, vertices_count))
+    {
+        unmap_file(data, size);
+        return false;
+    }
+
+    char const * const body_begin = reader.current;
+    size_t const body_size = static_cast<size_t>(file_end - body_begin);
+
+    // threads go through whole rest of file to find the last vertex record
+    // records are found only by brackets, so it is faster than parsing
+    std::vector<char const *> last_records(threads_count, nullptr);
+
+    run_dat_chunks_in_parallel(threads_count, [&](size_t i) noexcept
+        {
+            char const * const begin = body_begin + body_size * i / threads_count;
+            char const * const end = body_begin + body_size * (i + 1) / threads_count;
+
+            for (char const * record = find_dat_vertex_record(begin, end, file_end); record != end; record = find_dat_vertex_record(record + 1, end, file_end))
+            {
+                last_records[i] = record;
+            }
+        });
+
+    char const * section_end = body_begin;
+    for (char const * record : last_records)
+    {
+        section_end = record != nullptr ? record + 1 : section_end;
+    }
+
+    // vertex section is split evenly, records are counted to know index of the first record of every chunk
+    size_t const section_size = static_cast<size_t>(section_end - body_begin);
+    std::vector<DatVertexChunk> chunks(threads_count, DatVertexChunk{});
+
+    run_dat_chunks_in_parallel(threads_count, [&](size_t i) noexcept
+        {
+            char const * const begin = body_begin + section_size * i / threads_count;
+            char const * const end = body_begin + section_size * (i + 1) / threads_count;
+
+            DatVertexChunk & chunk = chunks[i];
+            chunk.first_record = find_dat_vertex_record(begin, end, file_end);
+
+            for (char const * record = chunk.first_record; record != end; record = find_dat_vertex_record(record + 1, end, file_end))
+            {
+                ++chunk.records_count;
+            }
+        });
+
+    size_t records_count = 0;
+    for (DatVertexChunk & chunk : chunks)
+    {
+        chunk.first_index = records_count;
+        records_count += chunk.records_count;
+    }
+
+    if (records_count != vertices_count)
+    {
+        unmap_file(data, size);
+        return false;
+    }
+
+    resize_vertices(vertices_count);
+
+    run_dat_chunks_in_parallel(threads_count, [&](size_t i) noexcept(!IS_DEBUG)
+        {
+            DatVertexChunk & chunk = chunks[i];
+            DatMemoryReader chunk_reader{ chunk.first_record, file_end };
+
+            bool is_parsed = true;
+
+            for (size_t j = 0; j < chunk.records_count && is_parsed; ++j)
+            {
+                frm::Point coordinate;
+                size_t edge = 0;
+                size_t flag;
+
+                is_parsed =
+                    read_dat_float(chunk_reader, coordinate.x) &&
+                    read_dat_float(chunk_reader, coordinate.y) &&
+                    (type == GeometryFileType::Vvve || (read_dat_index(chunk_reader, edge) && read_dat_index(chunk_reader, flag)));
+
+                if (is_parsed)
+                {
+                    set_vertex(chunk.first_index + j, coordinate, edge);
+                }
+            }
+
+            chunk.records_end = chunk_reader.current;
+            chunk.is_parsed = is_parsed;
+        });
+
+    // the rest of file goes after the last vertex
+    reader.current = body_begin;
+    bool is_parsed = true;
+
+    for (DatVertexChunk const & chunk : chunks)
+    {
+        is_parsed = is_parsed && chunk.is_parsed;
+        reader.current = chunk.records_count != 0 ? chunk.records_end : reader.current;
+    }
+
+    DatBatch batch{};
+
+    is_parsed = is_parsed && parse_dat_sections(reader, type, 1, size_t{ 1 } << 16, batch, [&consumer](DatBatch & filled_batch) noexcept(!IS_DEBUG)
+        {
+            consumer(filled_batch);
+        });
+
+    unmap_file(data, size);
+
+    return is_parsed;
+}
+
+void add_dat_batch_to_vvve(DatBatch const & batch, frm::vvve::VVVE & vvve) noexcept(!IS_DEBUG)
+{
+    if (batch.section == DatSection::Vertices)
+    {
+        vvve.vertices.resize(batch.section_size);
+
+        for (size_t i = 0; i < batch.records_count; ++i)
+        {
+            vvve.vertices[batch.first_index + i].coordinate = batch.coordinates[i];
+        }
+    }
+    else
+    {
+        vvve.edges.reserve(batch.section_size);
+
+        for (size_t i = 0; i < batch.records_count; ++i)
+        {
+            vvve.edges.push_back({ batch.indices[2 * i], batch.indices[2 * i + 1] });
+        }
+    }
+}
+
+void add_dat_batch_to_dcel(DatBatch const & batch, frm::dcel::DCEL & dcel) noexcept(!IS_DEBUG)
+{
+    if (batch.section == DatSection::Vertices)
+    {
+        dcel.vertices.resize(batch.section_size);
+
+        for (size_t i = 0; i < batch.records_count; ++i)
+        {
+            auto & vertex = dcel.vertices[batch.first_index + i];
+
+            vertex.coordinate = batch.coordinates[i];
+            vertex.edge = batch.indices[i];
+        }
+    }
+    else if (batch.section == DatSection::Faces)
+    {
+        dcel.faces.resize(batch.section_size);
+
+        for (size_t i = 0; i < batch.records_count; ++i)
+        {
+            dcel.faces[batch.first_index + i].edge = batch.indices[i];
+        }
+    }
+    else if (batch.section == DatSection::Edges)
+    {
+        dcel.edges.resize(batch.section_size);
+
+        for (size_t i = 0; i < batch.records_count; ++i)
+        {
+            auto & edge = dcel.edges[batch.first_index + i];
+            size_t const * const indices = batch.indices.data() + 5 * i;
+
+            edge.origin_vertex = indices[0];
+            edge.twin_edge = indices[1];
+            edge.incident_face = indices[2];
+            edge.next_edge = indices[3];
+            edge.previous_edge = indices[4];
+        }
+    }
+}
+
+// flags of vertices, faces and edges and lists of free records
+void add_dat_batch_to_dcel_records_state(DatBatch const & batch, DcelRecordsState & state) noexcept(!IS_DEBUG)
+{
+    bool const is_free_list =
+        batch.section == DatSection::FreeVertices || batch.section == DatSection::FreeFaces || batch.section == DatSection::FreeEdges;
+
+    std::vector<uint32_t> & values =
+        batch.section == DatSection::Vertices ? state.vertices_flag :
+        batch.section == DatSection::Faces ? state.faces_flag :
+        batch.section == DatSection::Edges ? state.edges_flag :
+        batch.section == DatSection::FreeVertices ? state.free_vertices :
+        batch.section == DatSection::FreeFaces ? state.free_faces :
+        state.free_edges;
+
+    std::vector<size_t> const & batch_values = is_free_list ? batch.indices : batch.flags;
+
+    values.resize(batch.section_size);
+
+    for (size_t i = 0; i < batch.records_count; ++i)
+    {
+        values[batch.first_index + i] = static_cast<uint32_t>(batch_values[i]);
+    }
+}
+
+bool load_vvve_by_streaming(std::string const & file_name, frm::vvve::VVVE & vvve) noexcept(!IS_DEBUG)
+{
+    vvve = frm::vvve::VVVE{};
+
+    bool const is_loaded = parse_dat_file(file_name, GeometryFileType::Vvve, [&vvve](DatBatch const & batch) noexcept(!IS_DEBUG)
+        {
+            add_dat_batch_to_vvve(batch, vvve);
+        });
+
+    if (!is_loaded)
+    {
+        vvve = frm::vvve::VVVE{};
+    }
+
+    return is_loaded;
+}
+
+bool load_dcel_by_streaming(std::string const & file_name, frm::dcel::DCEL & dcel) noexcept(!IS_DEBUG)
+{
+    dcel = frm::dcel::DCEL{};
+
+    bool const is_loaded = parse_dat_file(file_name, GeometryFileType::Dcel, [&dcel](DatBatch const & batch) noexcept(!IS_DEBUG)
+        {
+            add_dat_batch_to_dcel(batch, dcel);
+        });
+
+    if (!is_loaded)
+    {
+        dcel = frm::dcel::DCEL{};
+    }
+
+    return is_loaded;
+}
+
+bool load_dcel_by_streaming(std::string const & file_name, frm::dcel::DCEL & dcel, DcelRecordsState & state) noexcept(!IS_DEBUG)
+{
+    dcel = frm::dcel::DCEL{};
+    state = DcelRecordsState{};
+
+    bool const is_loaded = parse_dat_file(file_name, GeometryFileType::Dcel, [&dcel, &state](DatBatch const & batch) noexcept(!IS_DEBUG)
+        {
+            add_dat_batch_to_dcel(batch, dcel);
+            add_dat_batch_to_dcel_records_state(batch, state);
+        });
+
+    if (!is_loaded)
+    {
+        dcel = frm::dcel::DCEL{};
+        state = DcelRecordsState{};
+    }
+
+    return is_loaded;
+}
+
+bool load_vvve_in_parallel(std::string const & file_name, frm::vvve::VVVE & vvve, size_t threads_count) noexcept(!IS_DEBUG)
+{
+    vvve = frm::vvve::VVVE{};
+
+    bool const is_loaded = parse_dat_file_in_parallel(
+        file_name,
+        GeometryFileType::Vvve,
+        threads_count,
+        [&vvve](size_t vertices_count) noexcept(!IS_DEBUG)
+        {
+            vvve.vertices.resize(vertices_count);
+        },
+        [&vvve](size_t index, frm::Point coordinate, size_t) noexcept
+        {
+            vvve.vertices[index].coordinate = coordinate;
+        },
+        [&vvve](DatBatch const & batch) noexcept(!IS_DEBUG)
+        {
+            add_dat_batch_to_vvve(batch, vvve);
+        });
+
+    if (!is_loaded)
+    {
+        vvve = frm::vvve::VVVE{};
+    }
+
+    return is_loaded;
+}
+
+bool load_dcel_in_parallel(std::string const & file_name, frm::dcel::DCEL & dcel, size_t threads_count) noexcept(!IS_DEBUG)
+{
+    dcel = frm::dcel::DCEL{};
+
+    bool const is_loaded = parse_dat_file_in_parallel(
+        file_name,
+        GeometryFileType::Dcel,
+        threads_count,
+        [&dcel](size_t vertices_count) noexcept(!IS_DEBUG)
+        {
+            dcel.vertices.resize(vertices_count);
+        },
+        [&dcel](size_t index, frm::Point coordinate, size_t edge) noexcept
+        {
+            dcel.vertices[index].coordinate = coordinate;
+            dcel.vertices[index].edge = edge;
+        },
+        [&dcel](DatBatch const & batch) noexcept(!IS_DEBUG)
+        {
+            add_dat_batch_to_dcel(batch, dcel);
+        });
+
+    if (!is_loaded)
+    {
+        dcel = frm::dcel::DCEL{};
+    }
+
+    return is_loaded;
+}
\ No newline at end of file
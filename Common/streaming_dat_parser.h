@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include "dcel.h"
+#include "vvve.h"
+#include "geometry_file.h"
+
+#include <functional>
+
+
+enum class DatSection : uint8_t
+{
+    Vertices,
+    Faces,
+    Edges,
+    // lists of free records of dcel, one index per record
+    FreeVertices,
+    FreeFaces,
+    FreeEdges
+};
+
+// consecutive records of one section of Vvse_*.dat or Dcel_*.dat
+struct DatBatch
+{
+    DatSection section;
+
+    // index of first record in section and number of records in section
+    size_t first_index;
+    size_t section_size;
+
+    size_t records_count;
+
+    // vertices only
+    std::vector<frm::Point> coordinates;
+
+    // indices_per_record values for every record:
+    // vvve edges - begin, end
+    // dcel vertices - edge, dcel faces - edge, dcel edges - origin vertex, twin edge, incident face, next edge, previous edge
+    // free records - index of record
+    size_t indices_per_record;
+    std::vector<size_t> indices;
+
+    // dcel vertices, faces and edges only, the last number of every record
+    std::vector<size_t> flags;
+};
+
+// batches are given in order of file, batch is valid only during call
+using dat_batch_consumer_t = std::function<void(DatBatch const &)>;
+
+
+// file is read by blocks of block_size bytes and parsed on other thread, consumer is called on calling thread
+// parsing of next blocks goes on while consumer handles batch, at most two batches wait for consumer
+// memory use does not depend on size of file
+// returns false if file can not be read or does not match format, consumer may already have got batches
+bool parse_dat_file(
+    std::string const & file_name,
+    GeometryFileType type,
+    dat_batch_consumer_t const & consumer,
+    size_t block_size = 1 << 20,
+    size_t batch_size = 1 << 16
+) noexcept(!IS_DEBUG);
+
+// the same result as frm::vvve::load_from_file and frm::dcel::load_from_file, structures are filled while file is parsed
+bool load_vvve_by_streaming(std::string const & file_name, frm::vvve::VVVE & vvve) noexcept(!IS_DEBUG);
+bool load_dcel_by_streaming(std::string const & file_name, frm::dcel::DCEL & dcel) noexcept(!IS_DEBUG);
+
+// the same as load_dcel_by_streaming, flags and lists of free records are kept for save_dcel_to_geometry_file
+bool load_dcel_by_streaming(std::string const & file_name, frm::dcel::DCEL & dcel, DcelRecordsState & state) noexcept(!IS_DEBUG);
+
+// the same result as load_*_by_streaming, file is mapped to memory
+// vertex section is split at record boundaries and parsed by threads_count threads to preallocated array, 0 - number of hardware threads
+// other sections are parsed sequentially
+bool load_vvve_in_parallel(std::string const & file_name, frm::vvve::VVVE & vvve, size_t threads_count = 0) noexcept(!IS_DEBUG);
+bool load_dcel_in_parallel(std::string const & file_name, frm::dcel::DCEL & dcel, size_t threads_count = 0) noexcept(!IS_DEBUG);
+
+// from_chars-style parsing of whole [begin, end), false if it is not a number
+// up to 19 significant digits are used
+bool parse_dat_float(char const * begin, char const * end, float & value) noexcept;
+bool parse_dat_index(char const * begin, char const * end, size_t & value) noexcept;
\ No newline at end of file
@@ -1,28 +1,27 @@
 #include "divide_and_conquer.h"
+#include "geometry_kernel.h"
 
+#include <algorithm>
 #include <cassert>
 
 
-enum class Orientation : uint8_t
+bool is_lexicographically_less(frm::Point a, frm::Point b) noexcept
 {
-    Counterclockwise,
-    Clockwise,
-    Colinear
-};
-
-Orientation get_orientation(frm::Point p, frm::Point q, frm::Point r) noexcept
-{
-    float const orientation = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
-
-    if (abs(orientation) < frm::epsilon)
-    {
-        return Orientation::Colinear;
-    }
-    if (orientation > frm::epsilon)
+    if (a.x == b.x)
     {
-        return Orientation::Clockwise;
+        return a.y < b.y;
     }
-    return Orientation::Counterclockwise;
+
+    return a.x < b.x;
+}
+
+// from, point and next are on one line, next is farther from from than point on the same ray
+bool is_beyond(frm::Point from, frm::Point point, frm::Point next) noexcept
+{
+    // order of points on line is lexicographical order
+    return is_lexicographically_less(from, point) ?
+        is_lexicographically_less(point, next) :
+        is_lexicographically_less(next, point);
 }
 
 std::vector<size_t> jarvis_algorithm(frm::vvve::VVVE const & vvve, size_t from_index, size_t to_index) noexcept
@@ -48,11 +47,18 @@ std::vector<size_t> jarvis_algorithm(frm::vvve::VVVE const & vvve, size_t from_i
         size_t q = ((p + 1 - from_index) % size) + from_index;
         for (size_t i = from_index; i < to_index; ++i)
         {
-            if (get_orientation(
+            Orientation const orientation = get_orientation(
                 vvve.vertices[p].coordinate,
                 vvve.vertices[i].coordinate,
                 vvve.vertices[q].coordinate
-            ) == Orientation::Counterclockwise)
+            );
+
+            // the farthest of points on one line, so p is always vertex of hull
+            if (orientation == Orientation::Counterclockwise || (orientation == Orientation::Colinear && is_beyond(
+                vvve.vertices[p].coordinate,
+                vvve.vertices[q].coordinate,
+                vvve.vertices[i].coordinate
+            )))
             {
                 q = i;
             }
@@ -88,35 +94,6 @@ Quad quad(frm::Point point) noexcept
     return Quad::Force;
 }
 
-enum class SideByLine : uint8_t
-{
-    Left,
-    Right,
-    OnLine
-};
-
-SideByLine get_side(frm::Point begin, frm::Point end, frm::Point point) noexcept
-{
-    float const side = (end.y - begin.y) * (point.x - end.x) - (point.y - end.y) * (end.x - begin.x);
-
-    if (abs(side) < frm::epsilon)
-    {
-        return SideByLine::OnLine;
-    }
-    if (side > frm::epsilon)
-    {
-        return SideByLine::Right;
-    }
-    return SideByLine::Left;
-}
-
-constexpr SideByLine invert_side(SideByLine side) noexcept
-{
-    return (side == SideByLine::OnLine ? SideByLine::OnLine :
-        (side == SideByLine::Left ? SideByLine::Right : SideByLine::Left)
-        );
-}
-
 std::vector<size_t> merge(frm::vvve::VVVE const & vvve, std::vector<size_t> const & a, std::vector<size_t> const & b) noexcept
 {
     size_t const a_size = a.size();
@@ -127,7 +104,7 @@ std::vector<size_t> merge(frm::vvve::VVVE const & vvve, std::vector<size_t> cons
 
     for (size_t i = 1; i < a_size; ++i)
     {
-        if (vvve.vertices[a[i]].coordinate.x > vvve.vertices[a[rightmost_a_index]].coordinate.x)
+        if (is_lexicographically_less(vvve.vertices[a[rightmost_a_index]].coordinate, vvve.vertices[a[i]].coordinate))
         {
             rightmost_a_index = i;
         }
@@ -135,12 +112,29 @@ std::vector<size_t> merge(frm::vvve::VVVE const & vvve, std::vector<size_t> cons
 
     for (size_t i = 1; i < b_size; ++i)
     {
-        if (vvve.vertices[b[i]].coordinate.x < vvve.vertices[b[leftmost_b_index]].coordinate.x)
+        if (is_lexicographically_less(vvve.vertices[b[i]].coordinate, vvve.vertices[b[leftmost_b_index]].coordinate))
         {
             leftmost_b_index = i;
         }
     }
 
+    // tangent moves while next point of hull is on wrong side of it or on it and farther
+    auto const is_next_better = [&vvve](size_t point, size_t current, size_t next, SideByLine wrong_side) noexcept -> bool
+    {
+        frm::Point const point_coordinate = vvve.vertices[point].coordinate;
+        frm::Point const current_coordinate = vvve.vertices[current].coordinate;
+        frm::Point const next_coordinate = vvve.vertices[next].coordinate;
+
+        SideByLine const side = get_side(point_coordinate, current_coordinate, next_coordinate);
+
+        if (side == SideByLine::OnLine)
+        {
+            return is_beyond(point_coordinate, current_coordinate, next_coordinate);
+        }
+
+        return side == wrong_side;
+    };
+
     size_t index_a = rightmost_a_index;
     size_t index_b = leftmost_b_index;
     bool done = false;
@@ -148,20 +142,12 @@ std::vector<size_t> merge(frm::vvve::VVVE const & vvve, std::vector<size_t> cons
     {
         done = true;
 
-        while (get_side(
-            vvve.vertices[b[index_b]].coordinate,
-            vvve.vertices[a[index_a]].coordinate,
-            vvve.vertices[a[(index_a + 1) % a_size]].coordinate
-        ) != SideByLine::Left)
+        while (is_next_better(b[index_b], a[index_a], a[(index_a + 1) % a_size], SideByLine::Left))
         {
             index_a = (index_a + 1) % a_size;
         }
 
-        while (get_side(
-            vvve.vertices[a[index_a]].coordinate,
-            vvve.vertices[b[index_b]].coordinate,
-            vvve.vertices[b[(index_b + b_size - 1) % b_size]].coordinate
-        ) != SideByLine::Right)
+        while (is_next_better(a[index_a], b[index_b], b[(index_b + b_size - 1) % b_size], SideByLine::Right))
         {
             index_b = (index_b + b_size - 1) % b_size;
             done = false;
@@ -178,20 +164,12 @@ std::vector<size_t> merge(frm::vvve::VVVE const & vvve, std::vector<size_t> cons
     {
         done = true;
 
-        while (get_side(
-            vvve.vertices[a[index_a]].coordinate,
-            vvve.vertices[b[index_b]].coordinate,
-            vvve.vertices[b[(index_b + 1) % b_size]].coordinate
-        ) != SideByLine::Left)
+        while (is_next_better(a[index_a], b[index_b], b[(index_b + 1) % b_size], SideByLine::Left))
         {
             index_b = (index_b + 1) % b_size;
         }
 
-        while (get_side(
-            vvve.vertices[b[index_b]].coordinate,
-            vvve.vertices[a[index_a]].coordinate,
-            vvve.vertices[a[(index_a + a_size - 1) % a_size]].coordinate
-        ) != SideByLine::Right)
+        while (is_next_better(b[index_b], a[index_a], a[(index_a + a_size - 1) % a_size], SideByLine::Right))
         {
             index_a = (index_a + a_size - 1) % a_size;
             done = false;
@@ -248,17 +226,15 @@ void divide_and_conquer(frm::vvve::VVVE & vvve) noexcept(!IS_DEBUG)
 
     std::sort(vvve.vertices.begin(), vvve.vertices.end(), [](frm::vvve::VVVE::Vertex a, frm::vvve::VVVE::Vertex b) noexcept -> bool
         {
-            frm::Point point_a = a.coordinate;
-            frm::Point point_b = b.coordinate;
-
-            if (abs(point_a.x - point_b.x) < frm::epsilon)
-            {
-                return point_a.y < point_b.y;
-            }
-
-            return point_a.x < point_b.x;
+            return is_lexicographically_less(a.coordinate, b.coordinate);
         });
 
+    // equal points are on one line with any point, so only one of them is kept
+    vvve.vertices.erase(std::unique(vvve.vertices.begin(), vvve.vertices.end(), [](frm::vvve::VVVE::Vertex a, frm::vvve::VVVE::Vertex b) noexcept -> bool
+        {
+            return a.coordinate.x == b.coordinate.x && a.coordinate.y == b.coordinate.y;
+        }), vvve.vertices.end());
+
     std::vector<size_t> const hull = divide(vvve, 0, vvve.vertices.size());
 
     size_t previous_index = hull.size() - 1;
@@ -0,0 +1,80 @@
+#include "dcel.h"
+#include "vvve.h"
+#include "geometry_file.h"
+#include "streaming_dat_parser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+// usage: Geometry_file_converter vvve|dcel input_file output_file
+// binary input is written as text, text input of given type is written as binary
+int main(int argc, char ** argv)
+{
+    if (argc != 4 || (std::strcmp(argv[1], "vvve") != 0 && std::strcmp(argv[1], "dcel") != 0))
+    {
+        std::fprintf(stderr, "usage: Geometry_file_converter vvve|dcel input_file output_file\n");
+        return EXIT_FAILURE;
+    }
+
+    bool const is_vvve = std::strcmp(argv[1], "vvve") == 0;
+    std::string const input_file_name = argv[2];
+    std::string const output_file_name = argv[3];
+
+    auto const begin = std::chrono::steady_clock::now();
+
+    bool is_converted = false;
+    MappedGeometryFile mapped_file{};
+
+    if (map_geometry_file(input_file_name, mapped_file))
+    {
+        if ((mapped_file.type == GeometryFileType::Vvve) != is_vvve)
+        {
+            std::fprintf(stderr, "%s has other type\n", input_file_name.c_str());
+            return EXIT_FAILURE;
+        }
+
+        is_converted = is_vvve ?
+            save_vvve_view_to_text_file(mapped_file.vvve, output_file_name) :
+            save_dcel_view_to_text_file(mapped_file.dcel, output_file_name);
+    }
+    else if (is_vvve)
+    {
+        frm::vvve::VVVE vvve{};
+
+        if (!load_vvve_by_streaming(input_file_name, vvve))
+        {
+            std::fprintf(stderr, "can not read %s\n", input_file_name.c_str());
+            return EXIT_FAILURE;
+        }
+
+        is_converted = save_vvve_to_geometry_file(vvve, output_file_name);
+    }
+    else
+    {
+        frm::dcel::DCEL dcel{};
+        DcelRecordsState state{};
+
+        if (!load_dcel_by_streaming(input_file_name, dcel, state))
+        {
+            std::fprintf(stderr, "can not read %s\n", input_file_name.c_str());
+            return EXIT_FAILURE;
+        }
+
+        is_converted = save_dcel_to_geometry_file(dcel, output_file_name, state);
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+
+    if (!is_converted)
+    {
+        std::fprintf(stderr, "can not write %s\n", output_file_name.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%s -> %s: %.1f ms\n", input_file_name.c_str(), output_file_name.c_str(), std::chrono::duration<double, std::milli>(end - begin).count());
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
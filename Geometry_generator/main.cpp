@@ -0,0 +1,85 @@
+#include "geometry_generators.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+// usage: Geometry_generator kind count seed output_file
+// kind of point cloud: uniform, disk, circle, clustered, grid - count is number of points
+// kind of simple polygon: star, walk - count is number of vertices
+// kind of planar subdivision: voronoi, holes - count is number of cells on side of grid
+int main(int argc, char ** argv)
+{
+    char const * const usage = "usage: Geometry_generator uniform|disk|circle|clustered|grid|star|walk|voronoi|holes count seed output_file\n";
+
+    if (argc != 5)
+    {
+        std::fprintf(stderr, "%s", usage);
+        return EXIT_FAILURE;
+    }
+
+    char const * const kind = argv[1];
+    size_t const count = std::strtoull(argv[2], nullptr, 10);
+    size_t const seed = std::strtoull(argv[3], nullptr, 10);
+    std::string const file_name = argv[4];
+
+    auto const begin = std::chrono::steady_clock::now();
+
+    bool is_saved = false;
+
+    if (std::strcmp(kind, "uniform") == 0)
+    {
+        is_saved = save_random_point_cloud(file_name, PointCloudShape::Uniform, count, seed);
+    }
+    else if (std::strcmp(kind, "disk") == 0)
+    {
+        is_saved = save_random_point_cloud(file_name, PointCloudShape::Disk, count, seed);
+    }
+    else if (std::strcmp(kind, "circle") == 0)
+    {
+        is_saved = save_random_point_cloud(file_name, PointCloudShape::Circle, count, seed);
+    }
+    else if (std::strcmp(kind, "clustered") == 0)
+    {
+        is_saved = save_random_point_cloud(file_name, PointCloudShape::Clustered, count, seed);
+    }
+    else if (std::strcmp(kind, "grid") == 0)
+    {
+        is_saved = save_random_point_cloud(file_name, PointCloudShape::DegenerateGrid, count, seed);
+    }
+    else if (std::strcmp(kind, "star") == 0)
+    {
+        is_saved = save_random_simple_polygon(file_name, SimplePolygonShape::Star, count, seed);
+    }
+    else if (std::strcmp(kind, "walk") == 0)
+    {
+        is_saved = save_random_simple_polygon(file_name, SimplePolygonShape::RandomWalk, count, seed);
+    }
+    else if (std::strcmp(kind, "voronoi") == 0)
+    {
+        is_saved = save_voronoi_like_subdivision(file_name, count, seed);
+    }
+    else if (std::strcmp(kind, "holes") == 0)
+    {
+        is_saved = save_grid_subdivision_with_holes(file_name, count, seed);
+    }
+    else
+    {
+        std::fprintf(stderr, "%s", usage);
+        return EXIT_FAILURE;
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+
+    if (!is_saved)
+    {
+        std::fprintf(stderr, "can not write %s\n", file_name.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%s: %.1f s\n", file_name.c_str(), std::chrono::duration<double>(end - begin).count());
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
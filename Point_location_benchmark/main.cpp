@@ -0,0 +1,328 @@
+#include "dcel.h"
+#include "slab_decomposition.h"
+#include "frozen_slab_decomposition.h"
+#include "trapezoidal_decomposition.h"
+#include "trapezoidal_decomposition_statistics.h"
+#include "frozen_trapezoidal_decomposition.h"
+#include "geometry_generators.h"
+
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <filesystem>
+
+
+// single queries and batch are not measured if their functions are not given
+struct BenchmarkResult
+{
+    double build_seconds{ 0. };
+    size_t bytes_used{ 0 };
+    double single_query_seconds{ -1. };
+    double batch_query_seconds{ -1. };
+    size_t mismatches_count{ 0 };
+};
+
+
+template<typename Function>
+double get_seconds(Function const & function) noexcept(!IS_DEBUG)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    function();
+    auto const end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+size_t get_mismatches_count(std::vector<size_t> const & faces, std::vector<size_t> const & expected_faces) noexcept
+{
+    size_t mismatches_count = 0;
+
+    for (size_t i = 0; i < faces.size(); ++i)
+    {
+        mismatches_count += faces[i] != expected_faces[i];
+    }
+
+    return mismatches_count;
+}
+
+template<typename Structure>
+void measure_single_queries(
+    Structure const & structure,
+    std::vector<frm::Point> const & points,
+    std::vector<size_t> const & expected_faces,
+    BenchmarkResult & result
+) noexcept(!IS_DEBUG)
+{
+    std::vector<size_t> faces(points.size());
+
+    result.single_query_seconds = get_seconds([&]() noexcept
+        {
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                faces[i] = get_face_index(structure, points[i]);
+            }
+        });
+
+    result.mismatches_count += get_mismatches_count(faces, expected_faces);
+}
+
+template<typename BatchQuery>
+void measure_batch_queries(
+    BatchQuery const & batch_query,
+    std::vector<frm::Point> const & points,
+    std::vector<size_t> const & expected_faces,
+    BenchmarkResult & result
+) noexcept(!IS_DEBUG)
+{
+    std::vector<size_t> faces{};
+
+    result.batch_query_seconds = get_seconds([&]() noexcept(!IS_DEBUG)
+        {
+            faces = batch_query(points);
+        });
+
+    result.mismatches_count += get_mismatches_count(faces, expected_faces);
+}
+
+size_t get_vertical_lines_bytes_used(vertical_lines const & lines) noexcept
+{
+    size_t bytes_used = sizeof(lines) + lines.second.capacity() * sizeof(lines.second[0]);
+
+    for (auto const & vertical_line : lines.second)
+    {
+        bytes_used += vertical_line.second.capacity() * sizeof(LineComponent);
+    }
+
+    return bytes_used;
+}
+
+size_t get_frozen_vertical_lines_bytes_used(FrozenVerticalLines const & lines) noexcept
+{
+    return sizeof(lines) +
+        lines.vertical_lines_nodes.capacity() * sizeof(FrozenVerticalLinesNode) +
+        lines.lines_offsets.capacity() * sizeof(uint32_t) +
+        lines.lines_nodes.capacity() * sizeof(FrozenLinesNode) +
+        lines.faces_over_line.capacity() * sizeof(uint32_t) +
+        lines.faces_under_slab.capacity() * sizeof(uint32_t);
+}
+
+void print_result(size_t cells_per_side, char const * engine_name, BenchmarkResult const & result, size_t queries_count) noexcept
+{
+    double const queries = static_cast<double>(queries_count);
+
+    std::printf("%8zu  %-18s %12.2f %12.1f ",
+        cells_per_side,
+        engine_name,
+        result.build_seconds * 1e3,
+        static_cast<double>(result.bytes_used) / 1024.
+    );
+
+    if (result.single_query_seconds < 0.)
+    {
+        std::printf("%14s ", "-");
+    }
+    else
+    {
+        std::printf("%14.2f ", queries / result.single_query_seconds / 1e6);
+    }
+
+    if (result.batch_query_seconds < 0.)
+    {
+        std::printf("%14s ", "-");
+    }
+    else
+    {
+        std::printf("%14.2f ", queries / result.batch_query_seconds / 1e6);
+    }
+
+    std::printf("%12zu\n", result.mismatches_count);
+}
+
+// name of file which does not exist in temporary directory, generated subdivisions never replace files of user
+std::string get_temporary_file_name() noexcept(!IS_DEBUG)
+{
+    std::error_code error{};
+    std::filesystem::path const directory = std::filesystem::temp_directory_path(error);
+
+    std::random_device random_device{};
+
+    while (true)
+    {
+        std::filesystem::path const path = directory / ("Point_location_benchmark_" + std::to_string(random_device()) + ".dat");
+
+        if (!std::filesystem::exists(path, error))
+        {
+            return path.string();
+        }
+    }
+}
+
+// usage: Point_location_benchmark [max_cells_per_side [queries_count [seed]]] [--statistics]
+// subdivisions have 8, 16, ..., max_cells_per_side cells per side, every engine answers the same queries
+// faces of all engines are compared with faces of slab decomposition
+int main(int argc, char ** argv)
+{
+    size_t numbers[] = { 128, 1000000, 1 };
+    size_t numbers_count = 0;
+    bool is_statistics_printed = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--statistics") == 0)
+        {
+            is_statistics_printed = true;
+        }
+        else if (numbers_count < std::size(numbers))
+        {
+            numbers[numbers_count++] = static_cast<size_t>(std::strtoull(argv[i], nullptr, 10));
+        }
+    }
+
+    size_t const max_cells_per_side = numbers[0];
+    size_t const queries_count = std::max(numbers[1], size_t{ 1 });
+    size_t const seed = numbers[2];
+
+    std::string const dcel_file_name = get_temporary_file_name();
+
+    std::printf("%8s  %-18s %12s %12s %14s %14s %12s\n", "cells", "engine", "build ms", "memory KiB", "single Mq/s", "batch Mq/s", "mismatches");
+
+    for (size_t cells_per_side = 8; cells_per_side <= max_cells_per_side; cells_per_side *= 2)
+    {
+        frm::dcel::DCEL dcel{};
+
+        if (!save_voronoi_like_subdivision(dcel_file_name, cells_per_side, seed + cells_per_side))
+        {
+            std::fprintf(stderr, "can not write %s\n", dcel_file_name.c_str());
+            return EXIT_FAILURE;
+        }
+        frm::dcel::load_from_file(dcel_file_name, dcel);
+        std::remove(dcel_file_name.c_str());
+
+        // queries are inside bounding box of vertices, it is inside outside rectangle of trapezoidal map
+        frm::Point min_point = dcel.vertices[0].coordinate;
+        frm::Point max_point = dcel.vertices[0].coordinate;
+
+        for (auto const & vertex : dcel.vertices)
+        {
+            min_point = { std::min(min_point.x, vertex.coordinate.x), std::min(min_point.y, vertex.coordinate.y) };
+            max_point = { std::max(max_point.x, vertex.coordinate.x), std::max(max_point.y, vertex.coordinate.y) };
+        }
+
+        std::mt19937_64 random_engine{ seed };
+        std::uniform_real_distribution<float> x_distribution{ min_point.x, max_point.x };
+        std::uniform_real_distribution<float> y_distribution{ min_point.y, max_point.y };
+
+        std::vector<frm::Point> points(queries_count);
+        for (frm::Point & point : points)
+        {
+            point = { x_distribution(random_engine), y_distribution(random_engine) };
+        }
+
+        std::vector<size_t> expected_faces(points.size());
+
+        // slab decomposition gives expected faces
+        {
+            BenchmarkResult result{};
+            vertical_lines lines{};
+
+            result.build_seconds = get_seconds([&]() noexcept(!IS_DEBUG)
+                {
+                    lines = generate_vertical_lines(dcel);
+                });
+            result.bytes_used = get_vertical_lines_bytes_used(lines);
+
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                expected_faces[i] = get_face_index(lines, points[i]);
+            }
+
+            measure_single_queries(lines, points, expected_faces, result);
+            measure_batch_queries([&lines](std::vector<frm::Point> const & points) noexcept(!IS_DEBUG)
+                {
+                    return get_face_indices(lines, points);
+                }, points, expected_faces, result);
+
+            print_result(cells_per_side, "slab", result, queries_count);
+
+            BenchmarkResult frozen_result{};
+            FrozenVerticalLines frozen_lines{};
+
+            frozen_result.build_seconds = result.build_seconds + get_seconds([&]() noexcept(!IS_DEBUG)
+                {
+                    frozen_lines = freeze_vertical_lines(lines);
+                });
+            frozen_result.bytes_used = get_frozen_vertical_lines_bytes_used(frozen_lines);
+
+            measure_single_queries(frozen_lines, points, expected_faces, frozen_result);
+            measure_batch_queries([&frozen_lines](std::vector<frm::Point> const & points) noexcept
+                {
+                    return get_face_indices(frozen_lines, points);
+                }, points, expected_faces, frozen_result);
+
+            print_result(cells_per_side, "frozen slab", frozen_result, queries_count);
+        }
+
+        {
+            BenchmarkResult result{};
+            trapezoid_data_and_graph_root_t trapezoid_data_and_graph_root{};
+            TrapezoidBuildStatistics build_statistics{};
+
+            result.build_seconds = get_seconds([&]() noexcept(!IS_DEBUG)
+                {
+                    trapezoid_data_and_graph_root = generate_trapezoid_data_and_graph_root_with_seed(
+                        dcel,
+                        std::default_random_engine::default_seed,
+                        is_statistics_printed ? &build_statistics : nullptr
+                    );
+                });
+
+            TrapezoidGraphStatistics const graph_statistics = get_trapezoid_graph_statistics(trapezoid_data_and_graph_root);
+            result.bytes_used = graph_statistics.bytes_used;
+
+            measure_single_queries(trapezoid_data_and_graph_root, points, expected_faces, result);
+
+            print_result(cells_per_side, "trapezoid", result, queries_count);
+
+            BenchmarkResult frozen_result{};
+            FrozenTrapezoidGraph graph{};
+
+            frozen_result.build_seconds = result.build_seconds + get_seconds([&]() noexcept(!IS_DEBUG)
+                {
+                    graph = freeze_trapezoid_graph(trapezoid_data_and_graph_root);
+                });
+            frozen_result.bytes_used = sizeof(graph) + graph.nodes.capacity() * sizeof(FrozenGraphNode);
+
+            measure_single_queries(graph, points, expected_faces, frozen_result);
+            measure_batch_queries([&graph](std::vector<frm::Point> const & points) noexcept
+                {
+                    return get_face_indices(graph, points);
+                }, points, expected_faces, frozen_result);
+
+            print_result(cells_per_side, "frozen trapezoid", frozen_result, queries_count);
+
+            // packets share the frozen graph, only their batch is measured
+            BenchmarkResult packet_result{};
+            packet_result.build_seconds = frozen_result.build_seconds;
+            packet_result.bytes_used = frozen_result.bytes_used;
+
+            measure_batch_queries([&graph](std::vector<frm::Point> const & points) noexcept
+                {
+                    return get_face_indices_by_packets(graph, points);
+                }, points, expected_faces, packet_result);
+
+            print_result(cells_per_side, "packet trapezoid", packet_result, queries_count);
+
+            if (is_statistics_printed)
+            {
+                std::printf("%s\n", get_trapezoid_statistics_json(graph_statistics, &build_statistics).c_str());
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
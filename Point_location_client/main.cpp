@@ -0,0 +1,240 @@
+#include "point_location_protocol.h"
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+
+struct LoadResult
+{
+    std::vector<double> latencies;
+    size_t errors_count{ 0 };
+    uint32_t min_index_version{ std::numeric_limits<uint32_t>::max() };
+    uint32_t max_index_version{ 0 };
+};
+
+
+// false if connection is broken
+bool send_request(
+    socket_t connection,
+    PointLocationRequestType type,
+    std::vector<float> const & coordinates,
+    PointLocationResponseHeader & response,
+    std::vector<uint32_t> & faces
+) noexcept
+{
+    PointLocationRequestHeader request{};
+    request.magic = point_location_protocol_magic;
+    request.type = type;
+    request.points_count = static_cast<uint32_t>(coordinates.size() / 2);
+
+    if (!send_all(connection, &request, sizeof(request)) ||
+        !send_all(connection, coordinates.data(), coordinates.size() * sizeof(float)) ||
+        !receive_all(connection, &response, sizeof(response)))
+    {
+        return false;
+    }
+
+    faces.resize(response.faces_count);
+
+    return receive_all(connection, faces.data(), faces.size() * sizeof(uint32_t));
+}
+
+// percentile of sorted values
+double get_percentile(std::vector<double> const & values, double percentile) noexcept
+{
+    if (values.empty())
+    {
+        return 0.;
+    }
+
+    size_t const index = static_cast<size_t>(percentile * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+// usage: Point_location_client [socket_path [connections_count [requests_count [points_count [rebuilds_count [seed]]]]]]
+// every connection sends requests_count requests of points_count random points in bounding box of index
+// rebuilds are requested by separate connection while load is running
+int main(int argc, char ** argv)
+{
+    std::string const socket_path = argc > 1 ? argv[1] : "point_location.sock";
+
+    size_t numbers[] = { 4, 1000, 256, 0, 1 };
+    for (int i = 2; i < argc && static_cast<size_t>(i - 2) < std::size(numbers); ++i)
+    {
+        numbers[i - 2] = static_cast<size_t>(std::strtoull(argv[i], nullptr, 10));
+    }
+
+    size_t const connections_count = std::max(numbers[0], size_t{ 1 });
+    size_t const requests_count = numbers[1];
+    size_t const points_count = std::min(std::max(numbers[2], size_t{ 1 }), size_t{ max_points_in_point_location_request });
+    size_t const rebuilds_count = numbers[3];
+    size_t const seed = numbers[4];
+
+    if (!initialize_sockets())
+    {
+        std::fprintf(stderr, "can not initialize sockets\n");
+        return EXIT_FAILURE;
+    }
+
+    PointLocationResponseHeader info{};
+
+    {
+        socket_t const connection = connect_to_socket(socket_path);
+        std::vector<uint32_t> faces{};
+
+        if (connection == invalid_socket || !send_request(connection, PointLocationRequestType::GetInfo, {}, info, faces))
+        {
+            std::fprintf(stderr, "can not connect to %s\n", socket_path.c_str());
+            return EXIT_FAILURE;
+        }
+
+        close_socket(connection);
+    }
+
+    std::vector<LoadResult> results(connections_count);
+    std::atomic<size_t> running_connections_count{ connections_count };
+
+    auto const load = [&](size_t connection_index) noexcept
+    {
+        LoadResult & result = results[connection_index];
+        result.latencies.reserve(requests_count);
+
+        socket_t const connection = connect_to_socket(socket_path);
+
+        if (connection == invalid_socket)
+        {
+            result.errors_count = requests_count;
+            --running_connections_count;
+            return;
+        }
+
+        std::mt19937_64 random_engine{ seed + connection_index };
+        std::uniform_real_distribution<float> x_distribution{ info.min_x, info.max_x };
+        std::uniform_real_distribution<float> y_distribution{ info.min_y, info.max_y };
+
+        std::vector<float> coordinates(2 * points_count);
+        std::vector<uint32_t> faces{};
+
+        for (size_t i = 0; i < requests_count; ++i)
+        {
+            for (size_t j = 0; j < coordinates.size(); j += 2)
+            {
+                coordinates[j] = x_distribution(random_engine);
+                coordinates[j + 1] = y_distribution(random_engine);
+            }
+
+            PointLocationResponseHeader response{};
+
+            auto const begin = std::chrono::steady_clock::now();
+            bool const is_sent = send_request(connection, PointLocationRequestType::GetFaceIndices, coordinates, response, faces);
+            auto const end = std::chrono::steady_clock::now();
+
+            if (!is_sent)
+            {
+                result.errors_count += requests_count - i;
+                break;
+            }
+
+            if (response.status != PointLocationResponseStatus::Ok || response.faces_count != points_count)
+            {
+                ++result.errors_count;
+            }
+
+            result.latencies.push_back(std::chrono::duration<double>(end - begin).count());
+            result.min_index_version = std::min(result.min_index_version, response.index_version);
+            result.max_index_version = std::max(result.max_index_version, response.index_version);
+        }
+
+        close_socket(connection);
+        --running_connections_count;
+    };
+
+    // rebuilds are spread over load, the last one may finish after load
+    auto const rebuild = [&]() noexcept
+    {
+        socket_t const connection = connect_to_socket(socket_path);
+
+        if (connection == invalid_socket)
+        {
+            return;
+        }
+
+        std::vector<uint32_t> faces{};
+
+        for (size_t i = 0; i < rebuilds_count && running_connections_count != 0; ++i)
+        {
+            PointLocationResponseHeader response{};
+
+            auto const begin = std::chrono::steady_clock::now();
+            bool const is_sent = send_request(connection, PointLocationRequestType::Rebuild, {}, response, faces);
+            auto const end = std::chrono::steady_clock::now();
+
+            if (!is_sent)
+            {
+                break;
+            }
+
+            std::printf("rebuild to version %u: %s, %.1f ms\n",
+                response.index_version,
+                response.status == PointLocationResponseStatus::Ok ? "ok" : "failed",
+                std::chrono::duration<double, std::milli>(end - begin).count()
+            );
+        }
+
+        close_socket(connection);
+    };
+
+    auto const begin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < connections_count; ++i)
+    {
+        threads.emplace_back(load, i);
+    }
+    if (rebuilds_count != 0)
+    {
+        threads.emplace_back(rebuild);
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+    double const seconds = std::chrono::duration<double>(end - begin).count();
+
+    LoadResult total{};
+    for (LoadResult const & result : results)
+    {
+        total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+        total.errors_count += result.errors_count;
+        total.min_index_version = std::min(total.min_index_version, result.min_index_version);
+        total.max_index_version = std::max(total.max_index_version, result.max_index_version);
+    }
+
+    std::sort(total.latencies.begin(), total.latencies.end());
+
+    double const answered_requests_count = static_cast<double>(total.latencies.size());
+
+    std::printf("requests: %zu, errors: %zu, index versions: %u..%u\n",
+        total.latencies.size(), total.errors_count, total.min_index_version, total.max_index_version);
+    std::printf("throughput: %.0f requests/s, %.2f Mpoints/s\n",
+        answered_requests_count / seconds, answered_requests_count * static_cast<double>(points_count) / seconds / 1e6);
+    std::printf("latency us: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+        get_percentile(total.latencies, 0.5) * 1e6,
+        get_percentile(total.latencies, 0.9) * 1e6,
+        get_percentile(total.latencies, 0.99) * 1e6,
+        get_percentile(total.latencies, 1.) * 1e6
+    );
+
+    return total.errors_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "dcel.h"
+#include "trapezoidal_decomposition.h"
+#include "frozen_trapezoidal_decomposition.h"
+#include "point_location_protocol.h"
+
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+
+
+static_assert(sizeof(frm::Point) == 2 * sizeof(float), "points are received without conversion");
+
+
+struct PointLocationIndex
+{
+    uint32_t version;
+
+    // queries outside bounding box of vertices are not passed to graph
+    frm::Point min_point;
+    frm::Point max_point;
+
+    FrozenTrapezoidGraph graph;
+};
+
+struct PointLocationServer
+{
+    std::string dcel_file_name;
+
+    // read and replaced only by std::atomic_load and std::atomic_store
+    // request holds its copy, so previous index lives until its last request is answered
+    std::shared_ptr<PointLocationIndex const> index;
+
+    // one rebuild at a time
+    std::mutex rebuild_mutex;
+};
+
+
+// nullptr if file has no vertices
+std::shared_ptr<PointLocationIndex const> build_point_location_index(std::string const & dcel_file_name, uint32_t version) noexcept(!IS_DEBUG)
+{
+    frm::dcel::DCEL dcel{};
+    frm::dcel::load_from_file(dcel_file_name, dcel);
+
+    if (dcel.vertices.empty() || dcel.faces.empty())
+    {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<PointLocationIndex>();
+
+    index->version = version;
+    index->min_point = dcel.vertices[0].coordinate;
+    index->max_point = dcel.vertices[0].coordinate;
+
+    for (auto const & vertex : dcel.vertices)
+    {
+        index->min_point = { std::min(index->min_point.x, vertex.coordinate.x), std::min(index->min_point.y, vertex.coordinate.y) };
+        index->max_point = { std::max(index->max_point.x, vertex.coordinate.x), std::max(index->max_point.y, vertex.coordinate.y) };
+    }
+
+    // the server lives long, a few more builds for short query paths pay off
+    size_t constexpr retries_count = 8;
+
+    index->graph = freeze_trapezoid_graph(generate_trapezoid_data_and_graph_root_with_bounded_path_length(
+        dcel,
+        std::default_random_engine::default_seed,
+        retries_count
+    ));
+
+    return index;
+}
+
+PointLocationResponseHeader get_response_header(
+    PointLocationIndex const & index,
+    PointLocationResponseStatus status,
+    uint32_t faces_count
+) noexcept
+{
+    PointLocationResponseHeader header{};
+
+    header.magic = point_location_protocol_magic;
+    header.status = status;
+    header.index_version = index.version;
+    header.faces_count = faces_count;
+    header.min_x = index.min_point.x;
+    header.min_y = index.min_point.y;
+    header.max_x = index.max_point.x;
+    header.max_y = index.max_point.y;
+
+    return header;
+}
+
+// requests are answered in order until connection is closed or request is malformed
+void serve_connection(PointLocationServer & server, socket_t connection) noexcept(!IS_DEBUG)
+{
+    std::vector<frm::Point> points{};
+    std::vector<uint32_t> faces{};
+
+    PointLocationRequestHeader request{};
+
+    while (receive_all(connection, &request, sizeof(request)))
+    {
+        std::shared_ptr<PointLocationIndex const> index = std::atomic_load(&server.index);
+
+        if (request.magic != point_location_protocol_magic || request.points_count > max_points_in_point_location_request)
+        {
+            PointLocationResponseHeader const response = get_response_header(*index, PointLocationResponseStatus::BadRequest, 0);
+            send_all(connection, &response, sizeof(response));
+            break;
+        }
+
+        if (request.type == PointLocationRequestType::GetFaceIndices)
+        {
+            points.resize(request.points_count);
+
+            if (!receive_all(connection, points.data(), points.size() * sizeof(frm::Point)))
+            {
+                break;
+            }
+
+            std::vector<size_t> const graph_faces = get_face_indices(index->graph, points);
+
+            faces.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                frm::Point const point = points[i];
+                bool const is_inside = point.x >= index->min_point.x && point.x <= index->max_point.x &&
+                    point.y >= index->min_point.y && point.y <= index->max_point.y;
+
+                faces[i] = static_cast<uint32_t>(is_inside ? graph_faces[i] : index->graph.outside_face);
+            }
+
+            PointLocationResponseHeader const response = get_response_header(*index, PointLocationResponseStatus::Ok, request.points_count);
+
+            if (!send_all(connection, &response, sizeof(response)) || !send_all(connection, faces.data(), faces.size() * sizeof(uint32_t)))
+            {
+                break;
+            }
+        }
+        else if (request.type == PointLocationRequestType::Rebuild)
+        {
+            PointLocationResponseStatus status = PointLocationResponseStatus::Ok;
+
+            {
+                std::lock_guard<std::mutex> const lock{ server.rebuild_mutex };
+
+                std::shared_ptr<PointLocationIndex const> const current_index = std::atomic_load(&server.index);
+                std::shared_ptr<PointLocationIndex const> next_index = build_point_location_index(server.dcel_file_name, current_index->version + 1);
+
+                if (next_index != nullptr)
+                {
+                    std::atomic_store(&server.index, next_index);
+                    index = std::move(next_index);
+                }
+                else
+                {
+                    status = PointLocationResponseStatus::RebuildFailed;
+                }
+            }
+
+            PointLocationResponseHeader const response = get_response_header(*index, status, 0);
+
+            if (!send_all(connection, &response, sizeof(response)))
+            {
+                break;
+            }
+        }
+        else
+        {
+            PointLocationResponseHeader const response = get_response_header(*index, PointLocationResponseStatus::Ok, 0);
+
+            if (!send_all(connection, &response, sizeof(response)))
+            {
+                break;
+            }
+        }
+    }
+
+    close_socket(connection);
+}
+
+// usage: Point_location_server [dcel_file_name [socket_path]]
+int main(int argc, char ** argv)
+{
+    PointLocationServer server{};
+    server.dcel_file_name = argc > 1 ? argv[1] : "Dcel_1.dat";
+
+    std::string const socket_path = argc > 2 ? argv[2] : "point_location.sock";
+
+    server.index = build_point_location_index(server.dcel_file_name, 0);
+
+    if (server.index == nullptr)
+    {
+        std::fprintf(stderr, "can not load %s\n", server.dcel_file_name.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (!initialize_sockets())
+    {
+        std::fprintf(stderr, "can not initialize sockets\n");
+        return EXIT_FAILURE;
+    }
+
+    socket_t const listening_socket = create_listening_socket(socket_path);
+
+    if (listening_socket == invalid_socket)
+    {
+        std::fprintf(stderr, "can not listen on %s\n", socket_path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("serving %s on %s\n", server.dcel_file_name.c_str(), socket_path.c_str());
+    std::fflush(stdout);
+
+    // one thread per connection, server is never stopped
+    while (true)
+    {
+        socket_t const connection = accept(listening_socket, nullptr, nullptr);
+
+        if (connection == invalid_socket)
+        {
+            continue;
+        }
+
+        std::thread(serve_connection, std::ref(server), connection).detach();
+    }
+}
\ No newline at end of file
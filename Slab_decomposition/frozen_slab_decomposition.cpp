@@ -0,0 +1,352 @@
+#include "frozen_slab_decomposition.h"
+#include "geometry_kernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <emmintrin.h>
+
+
+// queries of one group of get_face_indices go down together
+size_t constexpr interleaved_queries_count = 32;
+
+
+// in-order traversal of static B-tree gives sorted order
+// b_tree_to_sorted[p] is index in sorted order of key at position p, keys which only fill nodes get size
+void fill_b_tree_order(std::vector<size_t> & b_tree_to_sorted, size_t & sorted_index, size_t size, size_t node) noexcept
+{
+    if (node >= b_tree_to_sorted.size() / frozen_node_keys_count)
+    {
+        return;
+    }
+
+    for (size_t key = 0; key < frozen_node_keys_count; ++key)
+    {
+        fill_b_tree_order(b_tree_to_sorted, sorted_index, size, (frozen_node_keys_count + 1) * node + key + 1);
+        b_tree_to_sorted[frozen_node_keys_count * node + key] = sorted_index < size ? sorted_index++ : size;
+    }
+
+    fill_b_tree_order(b_tree_to_sorted, sorted_index, size, (frozen_node_keys_count + 1) * node + frozen_node_keys_count + 1);
+}
+
+std::vector<size_t> get_b_tree_order(size_t size) noexcept(!IS_DEBUG)
+{
+    size_t const nodes_count = (size + frozen_node_keys_count - 1) / frozen_node_keys_count;
+    std::vector<size_t> b_tree_to_sorted(frozen_node_keys_count * nodes_count);
+
+    size_t sorted_index = 0;
+    fill_b_tree_order(b_tree_to_sorted, sorted_index, size, 0);
+
+    return b_tree_to_sorted;
+}
+
+// number of set lanes, every lane is all ones or all zeros
+size_t get_set_lanes_count(__m128 const (&lanes)[4]) noexcept
+{
+    // set lane is -1 as integer
+    __m128i sum = _mm_add_epi32(
+        _mm_add_epi32(_mm_castps_si128(lanes[0]), _mm_castps_si128(lanes[1])),
+        _mm_add_epi32(_mm_castps_si128(lanes[2]), _mm_castps_si128(lanes[3])));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return static_cast<size_t>(-_mm_cvtsi128_si32(sum));
+}
+
+// number of vertical lines of node which are to the left of point
+size_t get_left_vertical_lines_count(FrozenVerticalLinesNode const & node, __m128 point_x) noexcept
+{
+    // the same rule as in get_face_index for vertical_lines, point on vertical line belongs to the right slab
+    // so negative epsilon is used, subtraction gives the same result as x - point.x with opposite sign
+    __m128 const epsilon = _mm_set1_ps(-frm::epsilon);
+
+    __m128 const is_left[4] =
+    {
+        is_right_of_vertical_line(point_x, _mm_load_ps(node.x), epsilon),
+        is_right_of_vertical_line(point_x, _mm_load_ps(node.x + 4), epsilon),
+        is_right_of_vertical_line(point_x, _mm_load_ps(node.x + 8), epsilon),
+        is_right_of_vertical_line(point_x, _mm_load_ps(node.x + 12), epsilon)
+    };
+
+    return get_set_lanes_count(is_left);
+}
+
+// number of lines of node which are not under point
+size_t get_upper_lines_count(FrozenLinesNode const & node, __m128 point_x, __m128 point_y) noexcept
+{
+    __m128 const is_over[4] =
+    {
+        is_over_line(point_x, point_y, _mm_load_ps(node.k), _mm_load_ps(node.c)),
+        is_over_line(point_x, point_y, _mm_load_ps(node.k + 4), _mm_load_ps(node.c + 4)),
+        is_over_line(point_x, point_y, _mm_load_ps(node.k + 8), _mm_load_ps(node.c + 8)),
+        is_over_line(point_x, point_y, _mm_load_ps(node.k + 12), _mm_load_ps(node.c + 12))
+    };
+
+    return frozen_node_keys_count - get_set_lanes_count(is_over);
+}
+
+// one step down static B-tree of nodes_count nodes, key is the first key of node for which predicate is false
+// position is the first such key of whole path, it is not changed if predicate is true for all keys of node
+// query which is below leaves is not changed, so every query can make as many steps as the longest path has
+void make_b_tree_step(size_t & node, size_t & position, size_t nodes_count, size_t key) noexcept
+{
+    bool const is_active = node < nodes_count;
+
+    // selects instead of branches, they are unpredictable
+    position = is_active & (key < frozen_node_keys_count) ? frozen_node_keys_count * node + key : position;
+    node = is_active ? (frozen_node_keys_count + 1) * node + key + 1 : node;
+}
+
+// number of steps of the longest path of static B-tree, it is path to the leftmost leaf
+size_t get_b_tree_depth(size_t nodes_count) noexcept
+{
+    size_t depth = 0;
+    for (size_t node = 0; node < nodes_count; node = (frozen_node_keys_count + 1) * node + 1)
+    {
+        ++depth;
+    }
+
+    return depth;
+}
+
+// all lines are under every point, queries which are below leaves read this node
+FrozenLinesNode get_padding_lines_node() noexcept
+{
+    FrozenLinesNode node{};
+    std::fill(std::begin(node.c), std::end(node.c), -std::numeric_limits<float>::infinity());
+    return node;
+}
+
+FrozenVerticalLines freeze_vertical_lines(vertical_lines const & lines) noexcept(!IS_DEBUG)
+{
+    assert(lines.second.size() < std::numeric_limits<uint32_t>::max());
+
+    FrozenVerticalLines frozen_lines{};
+
+    frozen_lines.outside_face = static_cast<uint32_t>(lines.first);
+
+    size_t const vertical_lines_count = lines.second.size();
+    std::vector<size_t> const vertical_lines_order = get_b_tree_order(vertical_lines_count);
+    size_t const slabs_count = vertical_lines_order.size() + 1;
+
+    frozen_lines.vertical_lines_nodes.resize(vertical_lines_order.size() / frozen_node_keys_count);
+
+    for (size_t position = 0; position < vertical_lines_order.size(); ++position)
+    {
+        size_t const vertical_line = vertical_lines_order[position];
+
+        frozen_lines.vertical_lines_nodes[position / frozen_node_keys_count].x[position % frozen_node_keys_count] =
+            vertical_line < vertical_lines_count ? lines.second[vertical_line].first : std::numeric_limits<float>::infinity();
+    }
+
+    frozen_lines.lines_offsets.reserve(slabs_count + 1);
+    frozen_lines.faces_under_slab.assign(slabs_count, frozen_lines.outside_face);
+
+    frozen_lines.lines_offsets.push_back(0);
+
+    for (size_t slab = 0; slab < slabs_count; ++slab)
+    {
+        // the first vertical line which is not to the left of slab
+        size_t const vertical_line = slab < vertical_lines_order.size() ? vertical_lines_order[slab] : vertical_lines_count;
+
+        // the same rule as in get_face_index for vertical_lines, slabs of the first and the last vertical lines are outside
+        if (vertical_line != 0 && vertical_line + 1 < vertical_lines_count)
+        {
+            std::vector<LineComponent> const & current_lines = lines.second[vertical_line].second;
+            std::vector<size_t> const current_lines_order = get_b_tree_order(current_lines.size());
+
+            if (!current_lines.empty())
+            {
+                assert(current_lines.back().face_under_line < std::numeric_limits<uint32_t>::max());
+
+                frozen_lines.faces_under_slab[slab] = static_cast<uint32_t>(current_lines.back().face_under_line);
+            }
+
+            size_t const first_node = frozen_lines.lines_nodes.size();
+            frozen_lines.lines_nodes.resize(first_node + current_lines_order.size() / frozen_node_keys_count);
+
+            for (size_t position = 0; position < current_lines_order.size(); ++position)
+            {
+                FrozenLinesNode & node = frozen_lines.lines_nodes[first_node + position / frozen_node_keys_count];
+                size_t const key = position % frozen_node_keys_count;
+
+                // lines which only fill nodes are under every point
+                if (current_lines_order[position] == current_lines.size())
+                {
+                    node.k[key] = 0;
+                    node.c[key] = -std::numeric_limits<float>::infinity();
+                    frozen_lines.faces_over_line.push_back(frozen_lines.faces_under_slab[slab]);
+
+                    continue;
+                }
+
+                LineComponent const & line = current_lines[current_lines_order[position]];
+
+                assert(line.face_over_line < std::numeric_limits<uint32_t>::max());
+
+                node.k[key] = line.k;
+                node.c[key] = line.c;
+                frozen_lines.faces_over_line.push_back(static_cast<uint32_t>(line.face_over_line));
+            }
+        }
+
+        assert(frozen_lines.lines_nodes.size() < std::numeric_limits<uint32_t>::max());
+
+        frozen_lines.lines_offsets.push_back(static_cast<uint32_t>(frozen_lines.lines_nodes.size()));
+    }
+
+    return frozen_lines;
+}
+
+FrozenVerticalLinesView get_frozen_vertical_lines_view(FrozenVerticalLines const & lines) noexcept
+{
+    FrozenVerticalLinesView view{};
+
+    view.outside_face = lines.outside_face;
+    view.vertical_lines_nodes_count = lines.vertical_lines_nodes.size();
+    view.lines_nodes_count = lines.lines_nodes.size();
+
+    view.vertical_lines_nodes = lines.vertical_lines_nodes.data();
+    view.lines_offsets = lines.lines_offsets.data();
+    view.faces_under_slab = lines.faces_under_slab.data();
+    view.lines_nodes = lines.lines_nodes.data();
+    view.faces_over_line = lines.faces_over_line.data();
+
+    return view;
+}
+
+size_t get_face_index(FrozenVerticalLines const & lines, frm::Point point) noexcept
+{
+    return get_face_index(get_frozen_vertical_lines_view(lines), point);
+}
+
+size_t get_face_index(FrozenVerticalLinesView const & lines, frm::Point point) noexcept
+{
+    static FrozenLinesNode const padding_node = get_padding_lines_node();
+
+    __m128 const point_x = _mm_set1_ps(point.x);
+    __m128 const point_y = _mm_set1_ps(point.y);
+
+    size_t const vertical_lines_nodes_count = lines.vertical_lines_nodes_count;
+    size_t const vertical_lines_depth = get_b_tree_depth(vertical_lines_nodes_count);
+
+    // the number of steps is the same for all points
+    size_t node = 0;
+    size_t slab = frozen_node_keys_count * vertical_lines_nodes_count;
+    for (size_t step = 0; step < vertical_lines_depth; ++step)
+    {
+        FrozenVerticalLinesNode const & current_node = lines.vertical_lines_nodes[node < vertical_lines_nodes_count ? node : 0];
+        make_b_tree_step(node, slab, vertical_lines_nodes_count, get_left_vertical_lines_count(current_node, point_x));
+    }
+
+    size_t const lines_begin = lines.lines_offsets[slab];
+    size_t const lines_nodes_count = lines.lines_offsets[slab + 1] - lines_begin;
+    size_t const lines_depth = get_b_tree_depth(lines_nodes_count);
+    FrozenLinesNode const * const lines_nodes = lines.lines_nodes + lines_begin;
+
+    // the first line which is under the point
+    node = 0;
+    size_t line = frozen_node_keys_count * lines_nodes_count;
+    for (size_t step = 0; step < lines_depth; ++step)
+    {
+        FrozenLinesNode const & current_node = node < lines_nodes_count ? lines_nodes[node] : padding_node;
+        make_b_tree_step(node, line, lines_nodes_count, get_upper_lines_count(current_node, point_x, point_y));
+    }
+
+    if (line == frozen_node_keys_count * lines_nodes_count)
+    {
+        return lines.faces_under_slab[slab];
+    }
+
+    return lines.faces_over_line[frozen_node_keys_count * lines_begin + line];
+}
+
+std::vector<size_t> get_face_indices(FrozenVerticalLines const & lines, std::vector<frm::Point> const & points) noexcept
+{
+    return get_face_indices(get_frozen_vertical_lines_view(lines), points);
+}
+
+std::vector<size_t> get_face_indices(FrozenVerticalLinesView const & lines, std::vector<frm::Point> const & points) noexcept
+{
+    std::vector<size_t> face_indices(points.size());
+
+    // every query of group makes one step before the next step of any of them
+    // so node of query is loaded from memory while other queries make their steps
+    size_t nodes[interleaved_queries_count];
+    size_t positions[interleaved_queries_count];
+    size_t slabs[interleaved_queries_count];
+    size_t lines_begins[interleaved_queries_count];
+    size_t lines_nodes_counts[interleaved_queries_count];
+
+    static FrozenLinesNode const padding_node = get_padding_lines_node();
+
+    auto const prefetch = [](void const * address) noexcept
+    {
+        _mm_prefetch(static_cast<char const *>(address), _MM_HINT_T0);
+    };
+
+    size_t const vertical_lines_nodes_count = lines.vertical_lines_nodes_count;
+    size_t const vertical_lines_depth = get_b_tree_depth(vertical_lines_nodes_count);
+
+    for (size_t group_begin = 0; group_begin < points.size(); group_begin += interleaved_queries_count)
+    {
+        size_t const group_size = std::min(interleaved_queries_count, points.size() - group_begin);
+        frm::Point const * const group_points = points.data() + group_begin;
+
+        for (size_t query = 0; query < group_size; ++query)
+        {
+            nodes[query] = 0;
+            slabs[query] = frozen_node_keys_count * vertical_lines_nodes_count;
+        }
+
+        for (size_t step = 0; step < vertical_lines_depth; ++step)
+        {
+            for (size_t query = 0; query < group_size; ++query)
+            {
+                size_t const node = nodes[query];
+                FrozenVerticalLinesNode const & current_node = lines.vertical_lines_nodes[node < vertical_lines_nodes_count ? node : 0];
+                __m128 const point_x = _mm_set1_ps(group_points[query].x);
+
+                make_b_tree_step(nodes[query], slabs[query], vertical_lines_nodes_count, get_left_vertical_lines_count(current_node, point_x));
+                prefetch(lines.vertical_lines_nodes + nodes[query]);
+            }
+        }
+
+        size_t lines_depth = 0;
+        for (size_t query = 0; query < group_size; ++query)
+        {
+            lines_begins[query] = lines.lines_offsets[slabs[query]];
+            lines_nodes_counts[query] = lines.lines_offsets[slabs[query] + 1] - lines_begins[query];
+
+            nodes[query] = 0;
+            positions[query] = frozen_node_keys_count * lines_nodes_counts[query];
+
+            prefetch(lines.lines_nodes + lines_begins[query]);
+            lines_depth = std::max(lines_depth, get_b_tree_depth(lines_nodes_counts[query]));
+        }
+
+        for (size_t step = 0; step < lines_depth; ++step)
+        {
+            for (size_t query = 0; query < group_size; ++query)
+            {
+                size_t const node = nodes[query];
+                FrozenLinesNode const & current_node = node < lines_nodes_counts[query] ? lines.lines_nodes[lines_begins[query] + node] : padding_node;
+                __m128 const point_x = _mm_set1_ps(group_points[query].x);
+                __m128 const point_y = _mm_set1_ps(group_points[query].y);
+
+                make_b_tree_step(nodes[query], positions[query], lines_nodes_counts[query], get_upper_lines_count(current_node, point_x, point_y));
+                prefetch(lines.lines_nodes + lines_begins[query] + nodes[query]);
+            }
+        }
+
+        for (size_t query = 0; query < group_size; ++query)
+        {
+            face_indices[group_begin + query] = positions[query] == frozen_node_keys_count * lines_nodes_counts[query] ?
+                lines.faces_under_slab[slabs[query]] :
+                lines.faces_over_line[frozen_node_keys_count * lines_begins[query] + positions[query]];
+        }
+    }
+
+    return face_indices;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+
+#include "slab_decomposition.h"
+
+#include <cstdint>
+
+
+// keys of node of static B-tree, node i has children 17i + 1, ..., 17i + 17
+// key j of node i is placed in position 16i + j, it is between subtrees of children 17i + j + 1 and 17i + j + 2
+size_t constexpr frozen_node_keys_count = 16;
+
+// one cache line
+struct alignas(64) FrozenVerticalLinesNode
+{
+    float x[frozen_node_keys_count];
+};
+
+// two cache lines, k and c of line are loaded together
+struct alignas(64) FrozenLinesNode
+{
+    // y = k * x + c
+    float k[frozen_node_keys_count];
+    float c[frozen_node_keys_count];
+};
+
+// query-only copy of vertical_lines, all arrays are contiguous
+// keys are placed in static B-trees, keys which only fill the last nodes are after all keys in sorted order
+struct FrozenVerticalLines
+{
+    uint32_t outside_face;
+
+    // sorted by x
+    std::vector<FrozenVerticalLinesNode> vertical_lines_nodes;
+
+    // slab is indexed by position of the first vertical line which is not to the left of point, its lines are lines of that vertical line
+    // slab 16 * vertical_lines_nodes.size() is to the right of all vertical lines, slabs which are outside have no lines
+    // nodes of lines of i-th slab are placed in [lines_offsets[i], lines_offsets[i + 1]), sorted order is from top to bottom
+    std::vector<uint32_t> lines_offsets;
+    std::vector<FrozenLinesNode> lines_nodes;
+    // face over every line of lines_nodes, lines which fill nodes have face under slab
+    std::vector<uint32_t> faces_over_line;
+    // face under the lowest line of i-th slab
+    std::vector<uint32_t> faces_under_slab;
+};
+
+// FrozenVerticalLines without ownership, arrays can be placed in memory-mapped file
+struct FrozenVerticalLinesView
+{
+    uint32_t outside_face;
+    size_t vertical_lines_nodes_count;
+    size_t lines_nodes_count;
+
+    // vertical_lines_nodes_count elements
+    FrozenVerticalLinesNode const * vertical_lines_nodes;
+    // 16 * vertical_lines_nodes_count + 2 elements
+    uint32_t const * lines_offsets;
+    // 16 * vertical_lines_nodes_count + 1 elements
+    uint32_t const * faces_under_slab;
+    // lines_nodes_count elements
+    FrozenLinesNode const * lines_nodes;
+    // 16 * lines_nodes_count elements
+    uint32_t const * faces_over_line;
+};
+
+
+// O(n^2), n^2 is size of lines
+FrozenVerticalLines freeze_vertical_lines(vertical_lines const & lines) noexcept(!IS_DEBUG);
+
+// O(log(n))
+size_t get_face_index(FrozenVerticalLines const & lines, frm::Point point) noexcept;
+
+FrozenVerticalLinesView get_frozen_vertical_lines_view(FrozenVerticalLines const & lines) noexcept;
+
+// O(log(n))
+size_t get_face_index(FrozenVerticalLinesView const & lines, frm::Point point) noexcept;
+
+// the same as get_face_index for every point, interleaved queries hide latency of memory
+std::vector<size_t> get_face_indices(FrozenVerticalLines const & lines, std::vector<frm::Point> const & points) noexcept;
+
+// the same as get_face_index for every point, interleaved queries hide latency of memory
+std::vector<size_t> get_face_indices(FrozenVerticalLinesView const & lines, std::vector<frm::Point> const & points) noexcept;
\ No newline at end of file
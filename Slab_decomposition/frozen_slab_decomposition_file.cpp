@@ -0,0 +1,201 @@
+#include "frozen_slab_decomposition_file.h"
+#include "mapped_file.h"
+
+#include <fstream>
+#include <cstring>
+
+
+uint32_t constexpr frozen_vertical_lines_file_magic = 0x424c4153; // "SLAB"
+uint32_t constexpr frozen_vertical_lines_file_version = 2;
+size_t constexpr frozen_vertical_lines_file_alignment = 64;
+
+static_assert(sizeof(FrozenVerticalLinesFileHeader) == frozen_vertical_lines_file_alignment, "header must keep alignment of arrays");
+
+
+struct FrozenVerticalLinesFileLayout
+{
+    size_t vertical_lines_nodes;
+    size_t lines_offsets;
+    size_t faces_under_slab;
+    size_t lines_nodes;
+    size_t faces_over_line;
+
+    size_t file_size;
+};
+
+FrozenVerticalLinesFileLayout get_frozen_vertical_lines_file_layout(size_t vertical_lines_nodes_count, size_t lines_nodes_count) noexcept
+{
+    size_t current_offset = sizeof(FrozenVerticalLinesFileHeader);
+
+    auto const place_array = [&current_offset](size_t array_size) noexcept -> size_t
+    {
+        size_t const array_offset = current_offset;
+
+        current_offset += array_size;
+        current_offset = (current_offset + frozen_vertical_lines_file_alignment - 1) /
+            frozen_vertical_lines_file_alignment * frozen_vertical_lines_file_alignment;
+
+        return array_offset;
+    };
+
+    FrozenVerticalLinesFileLayout layout{};
+
+    size_t const slabs_count = frozen_node_keys_count * vertical_lines_nodes_count + 1;
+
+    layout.vertical_lines_nodes = place_array(sizeof(FrozenVerticalLinesNode) * vertical_lines_nodes_count);
+    layout.lines_offsets = place_array(sizeof(uint32_t) * (slabs_count + 1));
+    layout.faces_under_slab = place_array(sizeof(uint32_t) * slabs_count);
+    layout.lines_nodes = place_array(sizeof(FrozenLinesNode) * lines_nodes_count);
+    layout.faces_over_line = place_array(sizeof(uint32_t) * frozen_node_keys_count * lines_nodes_count);
+
+    layout.file_size = current_offset;
+
+    return layout;
+}
+
+// search gives slab and position of line which are in range by construction, only offsets are read from file
+// offsets which begin with 0, do not decrease and end with number of nodes are inside lines_nodes
+bool is_lines_offsets_valid(FrozenVerticalLinesView const & lines) noexcept
+{
+    size_t const slabs_count = frozen_node_keys_count * lines.vertical_lines_nodes_count + 1;
+
+    if (lines.lines_offsets[0] != 0 || lines.lines_offsets[slabs_count] != lines.lines_nodes_count)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < slabs_count; ++i)
+    {
+        if (lines.lines_offsets[i] > lines.lines_offsets[i + 1])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool save_frozen_vertical_lines(FrozenVerticalLines const & lines, std::string const & file_name) noexcept
+{
+    size_t const vertical_lines_nodes_count = lines.vertical_lines_nodes.size();
+    size_t const lines_nodes_count = lines.lines_nodes.size();
+
+    FrozenVerticalLinesFileLayout const layout = get_frozen_vertical_lines_file_layout(vertical_lines_nodes_count, lines_nodes_count);
+
+    FrozenVerticalLinesFileHeader header{};
+    header.magic = frozen_vertical_lines_file_magic;
+    header.version = frozen_vertical_lines_file_version;
+    header.outside_face = lines.outside_face;
+    header.vertical_lines_nodes_count = static_cast<uint32_t>(vertical_lines_nodes_count);
+    header.lines_nodes_count = static_cast<uint32_t>(lines_nodes_count);
+
+    // whole file is built in memory, it is written by one call
+    std::vector<char> buffer(layout.file_size, 0);
+
+    auto const copy_array = [&buffer](size_t offset, void const * data, size_t size) noexcept
+    {
+        if (size != 0)
+        {
+            std::memcpy(buffer.data() + offset, data, size);
+        }
+    };
+
+    copy_array(0, &header, sizeof(header));
+    copy_array(layout.vertical_lines_nodes, lines.vertical_lines_nodes.data(), sizeof(FrozenVerticalLinesNode) * lines.vertical_lines_nodes.size());
+    copy_array(layout.lines_offsets, lines.lines_offsets.data(), sizeof(uint32_t) * lines.lines_offsets.size());
+    copy_array(layout.faces_under_slab, lines.faces_under_slab.data(), sizeof(uint32_t) * lines.faces_under_slab.size());
+    copy_array(layout.lines_nodes, lines.lines_nodes.data(), sizeof(FrozenLinesNode) * lines.lines_nodes.size());
+    copy_array(layout.faces_over_line, lines.faces_over_line.data(), sizeof(uint32_t) * lines.faces_over_line.size());
+
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    return static_cast<bool>(file);
+}
+
+MappedFrozenVerticalLines::~MappedFrozenVerticalLines() noexcept
+{
+    unmap_frozen_vertical_lines(*this);
+}
+
+void unmap_frozen_vertical_lines(MappedFrozenVerticalLines & mapped_lines) noexcept
+{
+    if (mapped_lines.data != nullptr)
+    {
+        unmap_file(mapped_lines.data, mapped_lines.size);
+    }
+
+    mapped_lines.lines = FrozenVerticalLinesView{};
+    mapped_lines.data = nullptr;
+    mapped_lines.size = 0;
+}
+
+bool map_frozen_vertical_lines(std::string const & file_name, MappedFrozenVerticalLines & mapped_lines) noexcept
+{
+    unmap_frozen_vertical_lines(mapped_lines);
+
+    void const * data = nullptr;
+    size_t size = 0;
+
+    if (!map_file_for_reading(file_name, data, size))
+    {
+        return false;
+    }
+
+    mapped_lines.data = data;
+    mapped_lines.size = size;
+
+    if (size < sizeof(FrozenVerticalLinesFileHeader))
+    {
+        unmap_frozen_vertical_lines(mapped_lines);
+        return false;
+    }
+
+    FrozenVerticalLinesFileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != frozen_vertical_lines_file_magic ||
+        header.version != frozen_vertical_lines_file_version ||
+        header.vertical_lines_nodes_count == 0)
+    {
+        unmap_frozen_vertical_lines(mapped_lines);
+        return false;
+    }
+
+    FrozenVerticalLinesFileLayout const layout = get_frozen_vertical_lines_file_layout(header.vertical_lines_nodes_count, header.lines_nodes_count);
+
+    if (size < layout.file_size)
+    {
+        unmap_frozen_vertical_lines(mapped_lines);
+        return false;
+    }
+
+    char const * const bytes = static_cast<char const *>(data);
+
+    FrozenVerticalLinesView & lines = mapped_lines.lines;
+
+    lines.outside_face = header.outside_face;
+    lines.vertical_lines_nodes_count = header.vertical_lines_nodes_count;
+    lines.lines_nodes_count = header.lines_nodes_count;
+
+    lines.vertical_lines_nodes = reinterpret_cast<FrozenVerticalLinesNode const *>(bytes + layout.vertical_lines_nodes);
+    lines.lines_offsets = reinterpret_cast<uint32_t const *>(bytes + layout.lines_offsets);
+    lines.faces_under_slab = reinterpret_cast<uint32_t const *>(bytes + layout.faces_under_slab);
+    lines.lines_nodes = reinterpret_cast<FrozenLinesNode const *>(bytes + layout.lines_nodes);
+    lines.faces_over_line = reinterpret_cast<uint32_t const *>(bytes + layout.faces_over_line);
+
+    // offsets are used for indexing without checks, so corrupt file must not be mapped
+    if (!is_lines_offsets_valid(lines))
+    {
+        unmap_frozen_vertical_lines(mapped_lines);
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
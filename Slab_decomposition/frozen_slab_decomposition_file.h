@@ -0,0 +1,41 @@
+#pragma once
+
+
+#include "frozen_slab_decomposition.h"
+
+#include <string>
+
+
+// file is header and arrays of FrozenVerticalLinesView, every array begins on 64-byte boundary
+// numbers are stored in native byte order
+struct FrozenVerticalLinesFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t outside_face;
+    uint32_t vertical_lines_nodes_count;
+    uint32_t lines_nodes_count;
+    uint32_t reserved[11];
+};
+
+// read-only file mapping, pages are shared between processes by page cache
+struct MappedFrozenVerticalLines
+{
+    MappedFrozenVerticalLines() noexcept = default;
+    MappedFrozenVerticalLines(MappedFrozenVerticalLines const &) = delete;
+    MappedFrozenVerticalLines & operator=(MappedFrozenVerticalLines const &) = delete;
+    ~MappedFrozenVerticalLines() noexcept;
+
+    FrozenVerticalLinesView lines{};
+
+    void const * data{ nullptr };
+    size_t size{ 0 };
+};
+
+
+bool save_frozen_vertical_lines(FrozenVerticalLines const & lines, std::string const & file_name) noexcept;
+
+// previous mapping of mapped_lines is released, returns false if file is absent or has wrong format
+bool map_frozen_vertical_lines(std::string const & file_name, MappedFrozenVerticalLines & mapped_lines) noexcept;
+
+void unmap_frozen_vertical_lines(MappedFrozenVerticalLines & mapped_lines) noexcept;
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Application.h"
 #include "dcel.h"
 #include "slab_decomposition.h"
+#include "point_location_cache.h"
 
 
 int main()
@@ -9,32 +10,35 @@ int main()
 
     frm::dcel::load_from_file("Dcel_1.dat", dcel);
 
-    vertical_lines lines = generate_vertical_lines(dcel);
+    PointLocationCache<vertical_lines> lines_cache = create_point_location_cache(dcel, generate_vertical_lines);
 
-    size_t current_face = lines.first;
+    size_t current_face = get_point_location_snapshot(lines_cache)->structure.first;
 
     frm::Application application{};
 
-    application.set_on_event([&dcel, &current_face, &lines](sf::Event current_event) noexcept
+    application.set_on_event([&dcel, &current_face, &lines_cache](sf::Event current_event) noexcept
         {
             if (current_event.type == sf::Event::MouseButtonPressed)
             {
                 int x = current_event.mouseButton.x;
                 int y = current_event.mouseButton.y;
 
-                current_face = get_face_index(lines, { static_cast<float>(x), static_cast<float>(y) });
+                // snapshot is not changed by rebuild which is running meanwhile
+                auto const snapshot = get_point_location_snapshot(lines_cache);
+
+                current_face = get_face_index(snapshot->structure, { static_cast<float>(x), static_cast<float>(y) });
             }
         });
 
-    application.set_on_update([&dcel, &lines, &current_face](float dt, sf::RenderWindow & window) noexcept
+    application.set_on_update([&dcel, &lines_cache, &current_face](float dt, sf::RenderWindow & window) noexcept
         {
-            lines = generate_vertical_lines(dcel);
-
             frm::dcel::draw(dcel, window);
 
             frm::dcel::spawn_ui(dcel, window, "Dcel_1.dat");
 
-            if (current_face != lines.first)
+            update_point_location_cache(lines_cache, dcel, generate_vertical_lines);
+
+            if (current_face != get_point_location_snapshot(lines_cache)->structure.first)
             {
                 float color[4] = { 0.f, 0.f, 1.f, 0.5f };
                 frm::dcel::draw_face_highlighted(current_face, dcel, color, window);
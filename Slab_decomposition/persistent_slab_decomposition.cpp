@@ -0,0 +1,406 @@
+#include "persistent_slab_decomposition.h"
+
+#include <cassert>
+#include <algorithm>
+
+
+size_t constexpr null_node_index = std::numeric_limits<size_t>::max();
+
+
+// slab can be narrower than float step, so lines are compared in double
+// interpolation between ends is more precise than k * x + c far from zero
+double get_y_on_line(frm::dcel::DCEL const & dcel, PersistentLineNode const & node, double x) noexcept
+{
+    frm::Point const begin_point = dcel.vertices[node.begin_vertex_index].coordinate;
+    frm::Point const end_point = dcel.vertices[node.end_vertex_index].coordinate;
+
+    double const t = (x - begin_point.x) / (static_cast<double>(end_point.x) - begin_point.x);
+
+    return begin_point.y + (static_cast<double>(end_point.y) - begin_point.y) * t;
+}
+
+size_t get_node_height(std::vector<PersistentLineNode> const & nodes, size_t node_index) noexcept
+{
+    return node_index == null_node_index ? 0 : nodes[node_index].height;
+}
+
+void update_node_height(std::vector<PersistentLineNode> & nodes, size_t node_index) noexcept
+{
+    size_t const left_height = get_node_height(nodes, nodes[node_index].left_child);
+    size_t const right_height = get_node_height(nodes, nodes[node_index].right_child);
+
+    nodes[node_index].height = std::max(left_height, right_height) + 1;
+}
+
+size_t copy_node(std::vector<PersistentLineNode> & nodes, size_t node_index) noexcept
+{
+    // copy before push_back, reference can be invalidated by reallocation
+    PersistentLineNode const node = nodes[node_index];
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+// node_index must be already copied
+size_t rotate_node_right(std::vector<PersistentLineNode> & nodes, size_t node_index) noexcept
+{
+    size_t const left_index = copy_node(nodes, nodes[node_index].left_child);
+
+    nodes[node_index].left_child = nodes[left_index].right_child;
+    nodes[left_index].right_child = node_index;
+
+    update_node_height(nodes, node_index);
+    update_node_height(nodes, left_index);
+
+    return left_index;
+}
+
+// node_index must be already copied
+size_t rotate_node_left(std::vector<PersistentLineNode> & nodes, size_t node_index) noexcept
+{
+    size_t const right_index = copy_node(nodes, nodes[node_index].right_child);
+
+    nodes[node_index].right_child = nodes[right_index].left_child;
+    nodes[right_index].left_child = node_index;
+
+    update_node_height(nodes, node_index);
+    update_node_height(nodes, right_index);
+
+    return right_index;
+}
+
+// node_index must be already copied
+size_t balance_node(std::vector<PersistentLineNode> & nodes, size_t node_index) noexcept
+{
+    update_node_height(nodes, node_index);
+
+    size_t const left_index = nodes[node_index].left_child;
+    size_t const right_index = nodes[node_index].right_child;
+
+    size_t const left_height = get_node_height(nodes, left_index);
+    size_t const right_height = get_node_height(nodes, right_index);
+
+    if (left_height > right_height + 1)
+    {
+        if (get_node_height(nodes, nodes[left_index].left_child) < get_node_height(nodes, nodes[left_index].right_child))
+        {
+            size_t const new_left_index = rotate_node_left(nodes, copy_node(nodes, left_index));
+            nodes[node_index].left_child = new_left_index;
+        }
+
+        return rotate_node_right(nodes, node_index);
+    }
+
+    if (right_height > left_height + 1)
+    {
+        if (get_node_height(nodes, nodes[right_index].right_child) < get_node_height(nodes, nodes[right_index].left_child))
+        {
+            size_t const new_right_index = rotate_node_right(nodes, copy_node(nodes, right_index));
+            nodes[node_index].right_child = new_right_index;
+        }
+
+        return rotate_node_left(nodes, node_index);
+    }
+
+    return node_index;
+}
+
+// lines are compared by y in x, all lines in tree must cross vertical line in x
+size_t insert_node(
+    frm::dcel::DCEL const & dcel,
+    std::vector<PersistentLineNode> & nodes,
+    size_t root_index,
+    size_t new_node_index,
+    double x
+) noexcept
+{
+    if (root_index == null_node_index)
+    {
+        return new_node_index;
+    }
+
+    size_t const root_copy_index = copy_node(nodes, root_index);
+
+    double const new_y = get_y_on_line(dcel, nodes[new_node_index], x);
+    double const root_y = get_y_on_line(dcel, nodes[root_copy_index], x);
+
+    if (new_y < root_y)
+    {
+        size_t const new_left_index = insert_node(dcel, nodes, nodes[root_copy_index].left_child, new_node_index, x);
+        nodes[root_copy_index].left_child = new_left_index;
+    }
+    else
+    {
+        size_t const new_right_index = insert_node(dcel, nodes, nodes[root_copy_index].right_child, new_node_index, x);
+        nodes[root_copy_index].right_child = new_right_index;
+    }
+
+    return balance_node(nodes, root_copy_index);
+}
+
+size_t erase_min_node(std::vector<PersistentLineNode> & nodes, size_t root_index) noexcept
+{
+    if (nodes[root_index].left_child == null_node_index)
+    {
+        return nodes[root_index].right_child;
+    }
+
+    size_t const root_copy_index = copy_node(nodes, root_index);
+
+    size_t const new_left_index = erase_min_node(nodes, nodes[root_copy_index].left_child);
+    nodes[root_copy_index].left_child = new_left_index;
+
+    return balance_node(nodes, root_copy_index);
+}
+
+size_t erase_node(
+    frm::dcel::DCEL const & dcel,
+    std::vector<PersistentLineNode> & nodes,
+    size_t root_index,
+    size_t begin_vertex_index,
+    size_t end_vertex_index,
+    double y,
+    double x
+) noexcept(!IS_DEBUG)
+{
+    assert(root_index != null_node_index);
+
+    PersistentLineNode const root = nodes[root_index];
+
+    if (root.begin_vertex_index == begin_vertex_index && root.end_vertex_index == end_vertex_index)
+    {
+        if (root.left_child == null_node_index)
+        {
+            return root.right_child;
+        }
+        if (root.right_child == null_node_index)
+        {
+            return root.left_child;
+        }
+
+        size_t min_index = root.right_child;
+        while (nodes[min_index].left_child != null_node_index)
+        {
+            min_index = nodes[min_index].left_child;
+        }
+
+        size_t const new_right_index = erase_min_node(nodes, root.right_child);
+        size_t const replacement_index = copy_node(nodes, min_index);
+
+        nodes[replacement_index].left_child = root.left_child;
+        nodes[replacement_index].right_child = new_right_index;
+
+        return balance_node(nodes, replacement_index);
+    }
+
+    size_t const root_copy_index = copy_node(nodes, root_index);
+
+    if (y < get_y_on_line(dcel, root, x))
+    {
+        size_t const new_left_index = erase_node(dcel, nodes, root.left_child, begin_vertex_index, end_vertex_index, y, x);
+        nodes[root_copy_index].left_child = new_left_index;
+    }
+    else
+    {
+        size_t const new_right_index = erase_node(dcel, nodes, root.right_child, begin_vertex_index, end_vertex_index, y, x);
+        nodes[root_copy_index].right_child = new_right_index;
+    }
+
+    return balance_node(nodes, root_copy_index);
+}
+
+LineComponent get_line_between_vertices(
+    frm::dcel::DCEL const & dcel,
+    size_t begin_vertex_index,
+    size_t end_vertex_index,
+    size_t face_over_line,
+    size_t face_under_line
+) noexcept
+{
+    frm::Point const begin_point = dcel.vertices[begin_vertex_index].coordinate;
+    frm::Point const end_point = dcel.vertices[end_vertex_index].coordinate;
+
+    float const k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
+    float const c = end_point.y - k * end_point.x;
+
+    return { face_over_line, face_under_line, k, c };
+}
+
+
+PersistentVerticalLines generate_persistent_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG)
+{
+    assert(!dcel.vertices.empty());
+
+    PersistentVerticalLines result{};
+
+    std::vector<size_t> const vertices = get_sorted_vertices(dcel);
+
+    result.outside_face = get_outside_face(dcel, vertices[0]);
+
+    float const offset_to_both_side = 100.f * frm::epsilon;
+
+    VerticalLinesOfVertices const vertical_lines_of_vertices = get_vertical_lines_of_vertices(dcel, vertices);
+
+    std::vector<size_t> const & vertical_line_by_vertex = vertical_lines_of_vertices.vertical_line_by_vertex;
+    std::vector<float> const & vertical_lines_x = vertical_lines_of_vertices.vertical_lines_x;
+    std::vector<float> const & vertical_lines_last_x = vertical_lines_of_vertices.vertical_lines_last_x;
+
+    size_t root_index = null_node_index;
+    size_t vertex_position = 0;
+
+    for (size_t vertical_line = 0; vertical_line < vertical_lines_x.size(); ++vertical_line)
+    {
+        result.slabs_x.push_back(vertical_lines_x[vertical_line]);
+        result.slabs_root.push_back(root_index);
+
+        size_t const begin_vertex_position = vertex_position;
+        while (vertex_position < vertices.size() && vertical_line_by_vertex[vertices[vertex_position]] == vertical_line)
+        {
+            ++vertex_position;
+        }
+
+        // lines which end here are compared in the middle of left slab
+        if (vertical_line > 0)
+        {
+            double const middle_x = (static_cast<double>(vertical_lines_last_x[vertical_line - 1]) + vertical_lines_x[vertical_line]) / 2.;
+
+            for (size_t i = begin_vertex_position; i < vertex_position; ++i)
+            {
+                size_t const current_vertex_index = vertices[i];
+
+                std::vector<std::pair<size_t, size_t>> adjacents = frm::dcel::get_adjacent_vertices_and_edges(dcel, current_vertex_index);
+
+                for (std::pair<size_t, size_t> const & adjacent : adjacents)
+                {
+                    if (vertical_line_by_vertex[adjacent.first] < vertical_line)
+                    {
+                        PersistentLineNode erased_node{};
+                        erased_node.begin_vertex_index = adjacent.first;
+                        erased_node.end_vertex_index = current_vertex_index;
+
+                        root_index = erase_node(
+                            dcel,
+                            result.nodes,
+                            root_index,
+                            adjacent.first,
+                            current_vertex_index,
+                            get_y_on_line(dcel, erased_node, middle_x),
+                            middle_x
+                        );
+                    }
+                }
+            }
+        }
+
+        // lines which begin here are compared in the middle of right slab
+        if (vertical_line + 1 < vertical_lines_x.size())
+        {
+            double const middle_x = (static_cast<double>(vertical_lines_last_x[vertical_line]) + vertical_lines_x[vertical_line + 1]) / 2.;
+
+            for (size_t i = begin_vertex_position; i < vertex_position; ++i)
+            {
+                size_t const current_vertex_index = vertices[i];
+
+                std::vector<std::pair<size_t, size_t>> adjacents = frm::dcel::get_adjacent_vertices_and_edges(dcel, current_vertex_index);
+
+                for (std::pair<size_t, size_t> const & adjacent : adjacents)
+                {
+                    if (vertical_line_by_vertex[adjacent.first] > vertical_line)
+                    {
+                        PersistentLineNode new_node{};
+                        new_node.line = get_line_between_vertices(
+                            dcel,
+                            current_vertex_index,
+                            adjacent.first,
+                            dcel.edges[adjacent.second].incident_face,
+                            dcel.edges[dcel.edges[adjacent.second].twin_edge].incident_face
+                        );
+                        new_node.begin_vertex_index = current_vertex_index;
+                        new_node.end_vertex_index = adjacent.first;
+
+                        result.nodes.push_back(new_node);
+
+                        root_index = insert_node(dcel, result.nodes, root_index, result.nodes.size() - 1, middle_x);
+                    }
+                }
+            }
+        }
+    }
+
+    assert(root_index == null_node_index);
+
+    // additional part on right side
+    result.slabs_x.push_back(vertical_lines_last_x.back() + offset_to_both_side);
+    result.slabs_root.push_back(null_node_index);
+
+    result.nodes.shrink_to_fit();
+
+    return result;
+}
+
+size_t get_face_index(PersistentVerticalLines const & lines, frm::Point point) noexcept
+{
+    size_t left = 0;
+    size_t right = lines.slabs_x.size();
+
+    while (left + 1 != right && left != right)
+    {
+        size_t const middle = (right + left) / 2;
+
+        if (abs(lines.slabs_x[middle - 1] - point.x) < frm::epsilon)
+        {
+            left = middle;
+            right = middle + 1;
+        }
+        else if (lines.slabs_x[middle - 1] < point.x)
+        {
+            left = middle;
+        }
+        else
+        {
+            right = middle;
+        }
+    }
+
+    size_t const current_slab_index = right - 1;
+
+    if (current_slab_index == 0 || current_slab_index == lines.slabs_x.size() - 1)
+    {
+        return lines.outside_face;
+    }
+
+    size_t current_node_index = lines.slabs_root[current_slab_index];
+
+    if (current_node_index == null_node_index)
+    {
+        return lines.outside_face;
+    }
+
+    // the highest line under the point, or the lowest line if the point is under all lines
+    size_t line_under_point_index = null_node_index;
+    size_t last_node_index = null_node_index;
+
+    while (current_node_index != null_node_index)
+    {
+        PersistentLineNode const & current_node = lines.nodes[current_node_index];
+        last_node_index = current_node_index;
+
+        bool const is_point_over_line = frm::is_point_over_line(point, { current_node.line.k, current_node.line.c });
+
+        if (is_point_over_line)
+        {
+            line_under_point_index = current_node_index;
+            current_node_index = current_node.right_child;
+        }
+        else
+        {
+            current_node_index = current_node.left_child;
+        }
+    }
+
+    if (line_under_point_index != null_node_index)
+    {
+        return lines.nodes[line_under_point_index].line.face_over_line;
+    }
+
+    return lines.nodes[last_node_index].line.face_under_line;
+}
\ No newline at end of file
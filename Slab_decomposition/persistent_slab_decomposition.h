@@ -0,0 +1,37 @@
+#pragma once
+
+
+#include "slab_decomposition.h"
+
+
+// node of persistent AVL tree, nodes are never changed after slab is closed
+struct PersistentLineNode
+{
+    LineComponent line;
+
+    size_t begin_vertex_index;
+    size_t end_vertex_index;
+
+    size_t left_child{ std::numeric_limits<size_t>::max() };
+    size_t right_child{ std::numeric_limits<size_t>::max() };
+    size_t height{ 1 };
+};
+
+struct PersistentVerticalLines
+{
+    size_t outside_face;
+
+    // i-th slab is placed to the left of slabs_x[i], lines of slab are stored in tree with root slabs_root[i]
+    std::vector<float> slabs_x;
+    std::vector<size_t> slabs_root;
+
+    // nodes are shared between neighboring slabs
+    std::vector<PersistentLineNode> nodes;
+};
+
+
+// O(nlog(n))
+PersistentVerticalLines generate_persistent_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG);
+
+// O(log(n))
+size_t get_face_index(PersistentVerticalLines const & lines, frm::Point point) noexcept;
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <set>
 #include <cassert>
+#include <thread>
 
 
 size_t get_outside_face(frm::dcel::DCEL const & dcel, size_t left_vertex_index) noexcept(!IS_DEBUG)
@@ -48,10 +49,8 @@ size_t get_outside_face(frm::dcel::DCEL const & dcel, size_t left_vertex_index)
 }
 
 
-vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG)
+std::vector<size_t> get_sorted_vertices(frm::dcel::DCEL const & dcel) noexcept
 {
-    vertical_lines result{};
-
     std::vector<size_t> vertices(dcel.vertices.size());
     for (size_t i = 0; i < vertices.size(); ++i)
     {
@@ -63,7 +62,8 @@ vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!I
             frm::Point point_a = dcel.vertices[a].coordinate;
             frm::Point point_b = dcel.vertices[b].coordinate;
 
-            if (abs(point_a.x - point_b.x) < frm::epsilon)
+            // exact comparison, comparison with epsilon is not transitive
+            if (point_a.x == point_b.x)
             {
                 return point_a.y < point_b.y;
             }
@@ -71,13 +71,91 @@ vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!I
             return point_a.x < point_b.x;
         });
 
-    struct StatusComponent
+    return vertices;
+}
+
+VerticalLinesOfVertices get_vertical_lines_of_vertices(frm::dcel::DCEL const & dcel, std::vector<size_t> const & vertices) noexcept
+{
+    VerticalLinesOfVertices result{};
+    result.vertical_line_by_vertex.resize(dcel.vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); ++i)
     {
-        size_t begin_vertex_index;
-        size_t end_vertex_index;
-        size_t face_over_line;
-        size_t face_under_line;
-    };
+        size_t const current_vertex_index = vertices[i];
+        float const current_x = dcel.vertices[current_vertex_index].coordinate.x;
+
+        if (i == 0 || abs(current_x - result.vertical_lines_last_x.back()) > frm::epsilon)
+        {
+            result.vertical_lines_x.push_back(current_x);
+            result.vertical_lines_last_x.push_back(current_x);
+        }
+        result.vertical_lines_last_x.back() = current_x;
+
+        result.vertical_line_by_vertex[current_vertex_index] = result.vertical_lines_x.size() - 1;
+    }
+
+    return result;
+}
+
+
+struct StatusComponent
+{
+    size_t begin_vertex_index;
+    size_t end_vertex_index;
+    size_t face_over_line;
+    size_t face_under_line;
+};
+
+// all lines must cross vertical line in middle_x
+std::vector<LineComponent> get_lines_from_top_to_bottom(
+    frm::dcel::DCEL const & dcel,
+    std::vector<StatusComponent> const & status_components,
+    double middle_x
+) noexcept
+{
+    // slab can be narrower than float step, so lines are compared in double
+    std::vector<std::pair<double, size_t>> y_in_middle_and_index(status_components.size());
+
+    for (size_t i = 0; i < status_components.size(); ++i)
+    {
+        frm::Point const begin_point = dcel.vertices[status_components[i].begin_vertex_index].coordinate;
+        frm::Point const end_point = dcel.vertices[status_components[i].end_vertex_index].coordinate;
+
+        double const t = (middle_x - begin_point.x) / (static_cast<double>(end_point.x) - begin_point.x);
+
+        y_in_middle_and_index[i] = { begin_point.y + (static_cast<double>(end_point.y) - begin_point.y) * t, i };
+    }
+
+    std::sort(y_in_middle_and_index.begin(), y_in_middle_and_index.end(),
+        [](std::pair<double, size_t> const & a, std::pair<double, size_t> const & b) noexcept -> bool
+        {
+            return a.first > b.first;
+        });
+
+    std::vector<LineComponent> lines(status_components.size());
+
+    for (size_t i = 0; i < status_components.size(); ++i)
+    {
+        StatusComponent const & current_element = status_components[y_in_middle_and_index[i].second];
+
+        frm::Point begin_point = dcel.vertices[current_element.begin_vertex_index].coordinate;
+        frm::Point end_point = dcel.vertices[current_element.end_vertex_index].coordinate;
+
+        float const k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
+        float const c = end_point.y - k * end_point.x;
+
+        lines[i] = { current_element.face_over_line, current_element.face_under_line, k, c };
+    }
+
+    return lines;
+}
+
+
+vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG)
+{
+    vertical_lines result{};
+
+    std::vector<size_t> const vertices = get_sorted_vertices(dcel);
 
     auto const status_component_comparator = [](StatusComponent const & a, StatusComponent const & b) noexcept -> bool
     {
@@ -104,18 +182,13 @@ vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!I
 
         if (abs(current_x - last_x) > frm::epsilon)
         {
-            std::vector<LineComponent> current_vertical{};
-
-            for (StatusComponent const & current_element : status)
-            {
-                frm::Point begin_point = dcel.vertices[current_element.begin_vertex_index].coordinate;
-                frm::Point end_point = dcel.vertices[current_element.end_vertex_index].coordinate;
+            double const middle_x = (static_cast<double>(last_x) + current_x) / 2.;
 
-                float const k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
-                float const c = end_point.y - k * end_point.x;
-
-                current_vertical.push_back({ current_element.face_over_line, current_element.face_under_line, k, c });
-            }
+            std::vector<LineComponent> current_vertical = get_lines_from_top_to_bottom(
+                dcel,
+                { status.begin(), status.end() },
+                middle_x
+            );
 
             result.second.emplace_back(current_x, std::move(current_vertical));
         }
@@ -154,6 +227,175 @@ vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!I
     return result;
 }
 
+vertical_lines generate_vertical_lines_in_parallel(frm::dcel::DCEL const & dcel, size_t threads_count) noexcept(!IS_DEBUG)
+{
+    assert(!dcel.vertices.empty());
+
+    vertical_lines result{};
+
+    std::vector<size_t> const vertices = get_sorted_vertices(dcel);
+
+    result.first = get_outside_face(dcel, vertices[0]);
+
+    float const offset_to_both_side = 100.f * frm::epsilon;
+
+    VerticalLinesOfVertices const vertical_lines_of_vertices = get_vertical_lines_of_vertices(dcel, vertices);
+
+    std::vector<size_t> const & vertical_line_by_vertex = vertical_lines_of_vertices.vertical_line_by_vertex;
+    std::vector<float> const & vertical_lines_x = vertical_lines_of_vertices.vertical_lines_x;
+    std::vector<float> const & vertical_lines_last_x = vertical_lines_of_vertices.vertical_lines_last_x;
+
+    // edge from vertical line a to vertical line b belongs to slabs a + 1, ..., b
+    struct SlabEdge
+    {
+        StatusComponent status_component;
+        size_t begin_vertical_line;
+        size_t end_vertical_line;
+    };
+
+    std::vector<SlabEdge> edges{};
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        size_t const current_vertex_index = vertices[i];
+        size_t const current_vertical_line = vertical_line_by_vertex[current_vertex_index];
+
+        std::vector<std::pair<size_t, size_t>> adjacents = frm::dcel::get_adjacent_vertices_and_edges(dcel, current_vertex_index);
+
+        for (std::pair<size_t, size_t> const & adjacent : adjacents)
+        {
+            size_t const adjacent_vertical_line = vertical_line_by_vertex[adjacent.first];
+
+            if (adjacent_vertical_line > current_vertical_line)
+            {
+                SlabEdge new_edge{};
+                new_edge.status_component.begin_vertex_index = current_vertex_index;
+                new_edge.status_component.end_vertex_index = adjacent.first;
+                new_edge.status_component.face_over_line = dcel.edges[adjacent.second].incident_face;
+                new_edge.status_component.face_under_line = dcel.edges[dcel.edges[adjacent.second].twin_edge].incident_face;
+                new_edge.begin_vertical_line = current_vertical_line;
+                new_edge.end_vertical_line = adjacent_vertical_line;
+
+                edges.push_back(new_edge);
+            }
+        }
+    }
+
+    size_t const vertical_lines_count = vertical_lines_x.size();
+
+    // edge interval index, edges which begin and end on every vertical line
+    std::vector<size_t> begin_offsets(vertical_lines_count + 1, 0);
+    std::vector<size_t> end_offsets(vertical_lines_count + 1, 0);
+
+    for (SlabEdge const & edge : edges)
+    {
+        ++begin_offsets[edge.begin_vertical_line + 1];
+        ++end_offsets[edge.end_vertical_line + 1];
+    }
+    for (size_t i = 0; i < vertical_lines_count; ++i)
+    {
+        begin_offsets[i + 1] += begin_offsets[i];
+        end_offsets[i + 1] += end_offsets[i];
+    }
+
+    std::vector<size_t> edges_by_begin(edges.size());
+    std::vector<size_t> edges_by_end(edges.size());
+    {
+        std::vector<size_t> begin_positions(begin_offsets.begin(), begin_offsets.end() - 1);
+        std::vector<size_t> end_positions(end_offsets.begin(), end_offsets.end() - 1);
+
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            edges_by_begin[begin_positions[edges[i].begin_vertical_line]++] = i;
+            edges_by_end[end_positions[edges[i].end_vertical_line]++] = i;
+        }
+    }
+
+    result.second.resize(vertical_lines_count + 1);
+
+    // the same order as in status of serial version, it is almost sorted by y for most inputs
+    auto const edge_comparator = [&edges](size_t a, size_t b) noexcept -> bool
+    {
+        StatusComponent const & a_component = edges[a].status_component;
+        StatusComponent const & b_component = edges[b].status_component;
+
+        if (a_component.begin_vertex_index == b_component.begin_vertex_index)
+        {
+            return a_component.end_vertex_index < b_component.end_vertex_index;
+        }
+
+        return a_component.begin_vertex_index < b_component.begin_vertex_index;
+    };
+
+    auto const fill_slabs = [&](size_t first_slab, size_t last_slab) noexcept
+    {
+        std::set<size_t, decltype(edge_comparator)> status(edge_comparator);
+
+        // edges which begin before first slab and end in it or after it
+        for (size_t i = 0; i < begin_offsets[first_slab]; ++i)
+        {
+            size_t const edge_index = edges_by_begin[i];
+
+            if (edges[edge_index].end_vertical_line >= first_slab)
+            {
+                status.insert(edge_index);
+            }
+        }
+
+        std::vector<StatusComponent> status_components{};
+
+        for (size_t slab = first_slab; slab < last_slab; ++slab)
+        {
+            status_components.clear();
+            for (size_t edge_index : status)
+            {
+                status_components.push_back(edges[edge_index].status_component);
+            }
+
+            double const middle_x = slab == 0 ?
+                vertical_lines_x[0] :
+                (static_cast<double>(vertical_lines_last_x[slab - 1]) + vertical_lines_x[slab]) / 2.;
+
+            result.second[slab] = { vertical_lines_x[slab], get_lines_from_top_to_bottom(dcel, status_components, middle_x) };
+
+            for (size_t i = end_offsets[slab]; i < end_offsets[slab + 1]; ++i)
+            {
+                status.erase(edges_by_end[i]);
+            }
+            for (size_t i = begin_offsets[slab]; i < begin_offsets[slab + 1]; ++i)
+            {
+                status.insert(edges_by_begin[i]);
+            }
+        }
+    };
+
+    if (threads_count == 0)
+    {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads_count = std::min(threads_count, vertical_lines_count);
+
+    std::vector<std::thread> threads{};
+
+    for (size_t i = 0; i < threads_count; ++i)
+    {
+        size_t const first_slab = vertical_lines_count * i / threads_count;
+        size_t const last_slab = vertical_lines_count * (i + 1) / threads_count;
+
+        threads.emplace_back(fill_slabs, first_slab, last_slab);
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    // additional part on right side
+    result.second[vertical_lines_count] = { vertical_lines_last_x.back() + offset_to_both_side, std::vector<LineComponent>{} };
+
+    return result;
+}
+
 size_t get_face_index(vertical_lines const & lines, frm::Point point) noexcept
 {
     size_t left = 0;
@@ -219,3 +461,196 @@ size_t get_face_index(vertical_lines const & lines, frm::Point point) noexcept
         return current_line.face_under_line;
     }
 }
+
+
+
+// lines are sorted from top to bottom, so point is over some suffix of them
+// search of the first line of this suffix starts from the answer for previous point
+size_t get_first_line_under_point_from_hint(
+    std::vector<LineComponent> const & current_lines,
+    frm::Point point,
+    size_t hint
+) noexcept
+{
+    auto const is_point_over = [&current_lines, point](size_t line_index) noexcept -> bool
+    {
+        LineComponent const & current_line = current_lines[line_index];
+        return frm::is_point_over_line(point, { current_line.k, current_line.c });
+    };
+
+    size_t const size = current_lines.size();
+    hint = std::min(hint, size - 1);
+
+    // answer is in (left, right]
+    size_t left;
+    size_t right;
+
+    if (is_point_over(hint))
+    {
+        right = hint;
+        size_t step = 1;
+        while (step <= right && is_point_over(right - step))
+        {
+            right -= step;
+            step *= 2;
+        }
+
+        if (step > right)
+        {
+            left = std::numeric_limits<size_t>::max();
+        }
+        else
+        {
+            left = right - step;
+        }
+    }
+    else
+    {
+        left = hint;
+        size_t step = 1;
+        while (left + step < size && !is_point_over(left + step))
+        {
+            left += step;
+            step *= 2;
+        }
+
+        right = std::min(left + step, size);
+    }
+
+    // left == max means -1, so it is shifted by one
+    while (left + 1 != right)
+    {
+        size_t const middle = left + (right - left) / 2;
+
+        if (is_point_over(middle))
+        {
+            right = middle;
+        }
+        else
+        {
+            left = middle;
+        }
+    }
+
+    return right;
+}
+
+std::vector<size_t> get_face_indices(
+    vertical_lines const & lines,
+    std::vector<frm::Point> const & points,
+    size_t threads_count
+) noexcept(!IS_DEBUG)
+{
+    assert(!lines.second.empty());
+
+    std::vector<size_t> result(points.size());
+
+    // points of one column go one after another, so answers of neighbors are close
+    // points are copied together with indices to avoid random access during sweep
+    std::vector<std::pair<frm::Point, size_t>> sorted_points(points.size());
+    for (size_t i = 0; i < sorted_points.size(); ++i)
+    {
+        sorted_points[i] = { points[i], i };
+    }
+
+    std::sort(sorted_points.begin(), sorted_points.end(),
+        [](std::pair<frm::Point, size_t> const & a, std::pair<frm::Point, size_t> const & b) noexcept -> bool
+        {
+            if (a.first.x == b.first.x)
+            {
+                return a.first.y < b.first.y;
+            }
+
+            return a.first.x < b.first.x;
+        });
+
+    // the same rule as in get_face_index, point on vertical line belongs to the right slab
+    auto const is_vertical_line_to_left = [&lines](size_t vertical_line_index, frm::Point point) noexcept -> bool
+    {
+        float const x = lines.second[vertical_line_index].first;
+        return x < point.x || abs(x - point.x) < frm::epsilon;
+    };
+
+    auto const locate_points = [&](size_t first_point, size_t last_point) noexcept
+    {
+        if (first_point == last_point)
+        {
+            return;
+        }
+
+        // first slab of range is found by binary search, others by sweep
+        size_t current_lines_list_index = static_cast<size_t>(std::partition_point(
+            lines.second.begin(), lines.second.end(),
+            [&](std::pair<float, std::vector<LineComponent>> const & vertical) noexcept -> bool
+            {
+                return is_vertical_line_to_left(&vertical - lines.second.data(), sorted_points[first_point].first);
+            }) - lines.second.begin());
+
+        size_t hint = 0;
+
+        for (size_t i = first_point; i < last_point; ++i)
+        {
+            frm::Point const point = sorted_points[i].first;
+            size_t const point_index = sorted_points[i].second;
+
+            size_t const previous_lines_list_index = current_lines_list_index;
+            while (current_lines_list_index < lines.second.size() && is_vertical_line_to_left(current_lines_list_index, point))
+            {
+                ++current_lines_list_index;
+            }
+
+            if (previous_lines_list_index != current_lines_list_index)
+            {
+                hint = 0;
+            }
+
+            if (current_lines_list_index == 0 || current_lines_list_index >= lines.second.size() - 1)
+            {
+                result[point_index] = lines.first;
+                continue;
+            }
+
+            std::vector<LineComponent> const & current_lines = lines.second[current_lines_list_index].second;
+
+            if (current_lines.empty())
+            {
+                result[point_index] = lines.first;
+                continue;
+            }
+
+            hint = get_first_line_under_point_from_hint(current_lines, point, hint);
+
+            if (hint == current_lines.size())
+            {
+                result[point_index] = current_lines.back().face_under_line;
+            }
+            else
+            {
+                result[point_index] = current_lines[hint].face_over_line;
+            }
+        }
+    };
+
+    if (threads_count == 0)
+    {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads_count = std::max(std::min(threads_count, points.size()), size_t{ 1 });
+
+    std::vector<std::thread> threads{};
+
+    for (size_t i = 0; i < threads_count; ++i)
+    {
+        size_t const first_point = points.size() * i / threads_count;
+        size_t const last_point = points.size() * (i + 1) / threads_count;
+
+        threads.emplace_back(locate_points, first_point, last_point);
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    return result;
+}
\ No newline at end of file
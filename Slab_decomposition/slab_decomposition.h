@@ -14,10 +14,39 @@ struct LineComponent
 };
 
 // first parameter is outside face
+// lines of every vertical are sorted from top to bottom
 using vertical_lines = std::pair<size_t, std::vector<std::pair<float, std::vector<LineComponent>>>>;
 
+size_t get_outside_face(frm::dcel::DCEL const & dcel, size_t left_vertex_index) noexcept(!IS_DEBUG);
+
+// sorted by x, then by y
+std::vector<size_t> get_sorted_vertices(frm::dcel::DCEL const & dcel) noexcept;
+
+// vertices with the same x are placed on the same vertical line
+// vertical line is the most left vertex of group, the most right one is stored for slab middles
+struct VerticalLinesOfVertices
+{
+    std::vector<size_t> vertical_line_by_vertex;
+    std::vector<float> vertical_lines_x;
+    std::vector<float> vertical_lines_last_x;
+};
+
+// O(n), vertices are sorted by get_sorted_vertices
+VerticalLinesOfVertices get_vertical_lines_of_vertices(frm::dcel::DCEL const & dcel, std::vector<size_t> const & vertices) noexcept;
+
 // O(n^2)
 vertical_lines generate_vertical_lines(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG);
 
+// O(n^2 / threads_count), threads_count == 0 => hardware concurrency
+vertical_lines generate_vertical_lines_in_parallel(frm::dcel::DCEL const & dcel, size_t threads_count = 0) noexcept(!IS_DEBUG);
+
 // O(log(n))
-size_t get_face_index(vertical_lines const & lines, frm::Point point) noexcept;
\ No newline at end of file
+size_t get_face_index(vertical_lines const & lines, frm::Point point) noexcept;
+
+// O(mlog(m) + n), where m is number of points, result is in order of points
+// threads_count == 0 => hardware concurrency
+std::vector<size_t> get_face_indices(
+    vertical_lines const & lines,
+    std::vector<frm::Point> const & points,
+    size_t threads_count = 0
+) noexcept(!IS_DEBUG);
\ No newline at end of file
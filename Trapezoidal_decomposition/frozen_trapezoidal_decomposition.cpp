@@ -0,0 +1,453 @@
+#include "frozen_trapezoidal_decomposition.h"
+#include "geometry_kernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <xmmintrin.h>
+
+
+uint32_t constexpr frozen_graph_reference_type_bits = 2;
+uint32_t constexpr frozen_graph_reference_type_mask = (1u << frozen_graph_reference_type_bits) - 1;
+frozen_graph_reference_t constexpr null_frozen_graph_reference = std::numeric_limits<frozen_graph_reference_t>::max();
+
+// number of queries which are in flight, their cache misses overlap
+size_t constexpr interleaved_queries_count = 16;
+
+// two SSE registers of points
+size_t constexpr packet_size = 8;
+
+
+frozen_graph_reference_t get_frozen_graph_reference(GraphNode::Type type, size_t index) noexcept(!IS_DEBUG)
+{
+    assert(index < (std::numeric_limits<uint32_t>::max() >> frozen_graph_reference_type_bits));
+
+    return (static_cast<uint32_t>(index) << frozen_graph_reference_type_bits) | static_cast<uint32_t>(type);
+}
+
+GraphNode::Type get_frozen_graph_reference_type(frozen_graph_reference_t reference) noexcept
+{
+    return static_cast<GraphNode::Type>(reference & frozen_graph_reference_type_mask);
+}
+
+uint32_t get_frozen_graph_reference_index(frozen_graph_reference_t reference) noexcept
+{
+    return reference >> frozen_graph_reference_type_bits;
+}
+
+
+struct FrozenGraphNodeKey
+{
+    GraphNode::Type type;
+    FrozenGraphNode node;
+
+    bool operator==(FrozenGraphNodeKey const & other) const noexcept
+    {
+        return type == other.type &&
+            std::memcmp(&node, &other.node, sizeof(FrozenGraphNode)) == 0;
+    }
+};
+
+struct FrozenGraphNodeKeyHash
+{
+    size_t operator()(FrozenGraphNodeKey const & key) const noexcept
+    {
+        uint32_t values[4];
+        std::memcpy(values, &key.node, sizeof(values));
+
+        size_t hash = static_cast<size_t>(key.type);
+        for (uint32_t value : values)
+        {
+            hash = hash * 1000003 ^ value;
+        }
+        return hash;
+    }
+};
+
+struct FreezeTrapezoidGraphState
+{
+    TrapezoidData const & trapezoid_data;
+
+    // reference for every node of source graph, shared nodes are frozen once
+    std::vector<frozen_graph_reference_t> references;
+
+    // unique nodes in post order
+    std::vector<FrozenGraphNode> nodes;
+    std::unordered_map<FrozenGraphNodeKey, uint32_t, FrozenGraphNodeKeyHash> node_indices;
+};
+
+// post order, equal subgraphs become one node and tests with equal results are removed
+frozen_graph_reference_t freeze_graph_node(FreezeTrapezoidGraphState & state, uint32_t node_index) noexcept(!IS_DEBUG)
+{
+    if (state.references[node_index] != null_frozen_graph_reference)
+    {
+        return state.references[node_index];
+    }
+
+    GraphNode const & node = state.trapezoid_data.graph_nodes[node_index];
+
+    frozen_graph_reference_t reference;
+
+    if (node.type == GraphNode::Type::Leaf)
+    {
+        Trapezoid const & trapezoid = state.trapezoid_data.trapezoids[node.index_by_type];
+        size_t const face_index = state.trapezoid_data.line_segments[trapezoid.top_line_segment_index].face_under_line;
+
+        reference = get_frozen_graph_reference(GraphNode::Type::Leaf, face_index);
+    }
+    else
+    {
+        frozen_graph_reference_t const left_reference = freeze_graph_node(state, node.left_child);
+        frozen_graph_reference_t const right_reference = freeze_graph_node(state, node.right_child);
+
+        if (left_reference == right_reference)
+        {
+            reference = left_reference;
+        }
+        else
+        {
+            FrozenGraphNodeKey key{ node.type, {} };
+            key.node.left_child = left_reference;
+            key.node.right_child = right_reference;
+
+            if (node.type == GraphNode::Type::XUnit)
+            {
+                key.node.first = state.trapezoid_data.ends_of_line_segment[node.index_by_type].x;
+                key.node.second = 0.f;
+            }
+            else
+            {
+                LineSegment const & line_segment = state.trapezoid_data.line_segments[node.index_by_type];
+                key.node.first = line_segment.k;
+                key.node.second = line_segment.c;
+            }
+
+            auto const found = state.node_indices.find(key);
+
+            if (found != state.node_indices.end())
+            {
+                reference = get_frozen_graph_reference(node.type, found->second);
+            }
+            else
+            {
+                uint32_t const new_index = static_cast<uint32_t>(state.nodes.size());
+                state.nodes.push_back(key.node);
+                state.node_indices.emplace(key, new_index);
+
+                reference = get_frozen_graph_reference(node.type, new_index);
+            }
+        }
+    }
+
+    state.references[node_index] = reference;
+
+    return reference;
+}
+
+FrozenTrapezoidGraph freeze_trapezoid_graph(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG)
+{
+    TrapezoidData const & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+
+    FreezeTrapezoidGraphState state{ trapezoid_data, {}, {}, {} };
+    state.references.resize(trapezoid_data.graph_nodes.size(), null_frozen_graph_reference);
+
+    frozen_graph_reference_t const post_order_root = freeze_graph_node(state, trapezoid_data_and_graph_root.second.second);
+
+    FrozenTrapezoidGraph graph{};
+    graph.outside_face = trapezoid_data_and_graph_root.first;
+
+    if (get_frozen_graph_reference_type(post_order_root) == GraphNode::Type::Leaf)
+    {
+        graph.root = post_order_root;
+        return graph;
+    }
+
+    // BFS order, the first levels which are visited by every query are placed together
+    std::vector<uint32_t> bfs_indices(state.nodes.size(), std::numeric_limits<uint32_t>::max());
+    std::vector<uint32_t> post_order_indices{};
+    post_order_indices.reserve(state.nodes.size());
+
+    std::queue<uint32_t> bfs_queue{};
+
+    auto const visit = [&](frozen_graph_reference_t reference) noexcept
+    {
+        if (get_frozen_graph_reference_type(reference) == GraphNode::Type::Leaf)
+        {
+            return;
+        }
+
+        uint32_t const post_order_index = get_frozen_graph_reference_index(reference);
+
+        if (bfs_indices[post_order_index] == std::numeric_limits<uint32_t>::max())
+        {
+            bfs_indices[post_order_index] = static_cast<uint32_t>(post_order_indices.size());
+            post_order_indices.push_back(post_order_index);
+            bfs_queue.push(post_order_index);
+        }
+    };
+
+    visit(post_order_root);
+
+    while (!bfs_queue.empty())
+    {
+        FrozenGraphNode const & node = state.nodes[bfs_queue.front()];
+        bfs_queue.pop();
+
+        visit(node.left_child);
+        visit(node.right_child);
+    }
+
+    auto const get_bfs_reference = [&bfs_indices](frozen_graph_reference_t reference) noexcept -> frozen_graph_reference_t
+    {
+        GraphNode::Type const type = get_frozen_graph_reference_type(reference);
+
+        if (type == GraphNode::Type::Leaf)
+        {
+            return reference;
+        }
+
+        return get_frozen_graph_reference(type, bfs_indices[get_frozen_graph_reference_index(reference)]);
+    };
+
+    graph.root = get_bfs_reference(post_order_root);
+    graph.nodes.resize(post_order_indices.size());
+
+    for (size_t i = 0; i < post_order_indices.size(); ++i)
+    {
+        FrozenGraphNode node = state.nodes[post_order_indices[i]];
+        node.left_child = get_bfs_reference(node.left_child);
+        node.right_child = get_bfs_reference(node.right_child);
+
+        graph.nodes[i] = node;
+    }
+
+    return graph;
+}
+
+frozen_graph_reference_t get_next_frozen_graph_reference(FrozenGraphNode const & node, frozen_graph_reference_t current, frm::Point point) noexcept
+{
+    // the same tests as in get_trapezoid_index
+    bool is_left;
+    if (get_frozen_graph_reference_type(current) == GraphNode::Type::XUnit)
+    {
+        is_left = !is_right_of_vertical_line(point.x, node.first, frm::epsilon);
+    }
+    else
+    {
+        is_left = is_over_line(point.x, point.y, node.first, node.second);
+    }
+
+    return is_left ? node.left_child : node.right_child;
+}
+
+size_t get_face_index(FrozenTrapezoidGraph const & graph, frm::Point point) noexcept
+{
+    FrozenGraphNode const * const nodes = graph.nodes.data();
+
+    frozen_graph_reference_t current = graph.root;
+
+    while (get_frozen_graph_reference_type(current) != GraphNode::Type::Leaf)
+    {
+        FrozenGraphNode const & node = nodes[get_frozen_graph_reference_index(current)];
+
+        _mm_prefetch(reinterpret_cast<char const *>(nodes + get_frozen_graph_reference_index(node.left_child)), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<char const *>(nodes + get_frozen_graph_reference_index(node.right_child)), _MM_HINT_T0);
+
+        current = get_next_frozen_graph_reference(node, current, point);
+    }
+
+    return get_frozen_graph_reference_index(current);
+}
+
+std::vector<size_t> get_face_indices(FrozenTrapezoidGraph const & graph, std::vector<frm::Point> const & points) noexcept
+{
+    std::vector<size_t> face_indices(points.size());
+
+    FrozenGraphNode const * const nodes = graph.nodes.data();
+
+    // every slot is state of one query: index of point and current node
+    // slot makes one step and prefetches its next node, the node is loaded while other slots make their steps
+    size_t slots_point_index[interleaved_queries_count];
+    frozen_graph_reference_t slots_current[interleaved_queries_count];
+
+    size_t next_point_index = 0;
+    size_t active_slots_count = 0;
+
+    // query is started in the slot, queries which end in the root are answered immediately
+    auto const start_query = [&](size_t slot) noexcept -> bool
+    {
+        while (next_point_index < points.size())
+        {
+            size_t const point_index = next_point_index++;
+
+            if (get_frozen_graph_reference_type(graph.root) == GraphNode::Type::Leaf)
+            {
+                face_indices[point_index] = get_frozen_graph_reference_index(graph.root);
+                continue;
+            }
+
+            slots_point_index[slot] = point_index;
+            slots_current[slot] = graph.root;
+
+            return true;
+        }
+
+        return false;
+    };
+
+    while (active_slots_count < interleaved_queries_count && start_query(active_slots_count))
+    {
+        ++active_slots_count;
+    }
+
+    while (active_slots_count != 0)
+    {
+        for (size_t slot = 0; slot < active_slots_count;)
+        {
+            frozen_graph_reference_t const current = slots_current[slot];
+            frm::Point const point = points[slots_point_index[slot]];
+
+            frozen_graph_reference_t const next = get_next_frozen_graph_reference(nodes[get_frozen_graph_reference_index(current)], current, point);
+
+            if (get_frozen_graph_reference_type(next) != GraphNode::Type::Leaf)
+            {
+                _mm_prefetch(reinterpret_cast<char const *>(nodes + get_frozen_graph_reference_index(next)), _MM_HINT_T0);
+
+                slots_current[slot] = next;
+                ++slot;
+                continue;
+            }
+
+            face_indices[slots_point_index[slot]] = get_frozen_graph_reference_index(next);
+
+            if (start_query(slot))
+            {
+                ++slot;
+                continue;
+            }
+
+            // no more points, the last active slot takes place of finished one
+            --active_slots_count;
+            slots_point_index[slot] = slots_point_index[active_slots_count];
+            slots_current[slot] = slots_current[active_slots_count];
+        }
+    }
+
+    return face_indices;
+}
+
+// lanes of mask which go to the left child of node
+uint32_t get_packet_left_mask(FrozenGraphNode const & node, GraphNode::Type type, __m128 const (&x)[2], __m128 const (&y)[2]) noexcept
+{
+    __m128 const first = _mm_set1_ps(node.first);
+
+    // the same tests as in get_next_frozen_graph_reference
+    if (type == GraphNode::Type::XUnit)
+    {
+        __m128 const epsilon = _mm_set1_ps(frm::epsilon);
+
+        __m128 const right_lanes[2] = {
+            is_right_of_vertical_line(x[0], first, epsilon),
+            is_right_of_vertical_line(x[1], first, epsilon)
+        };
+
+        return ~static_cast<uint32_t>(_mm_movemask_ps(right_lanes[0]) | (_mm_movemask_ps(right_lanes[1]) << 4)) & ((1u << packet_size) - 1);
+    }
+
+    __m128 const second = _mm_set1_ps(node.second);
+
+    __m128 const left_lanes[2] = {
+        is_over_line(x[0], y[0], first, second),
+        is_over_line(x[1], y[1], first, second)
+    };
+
+    return static_cast<uint32_t>(_mm_movemask_ps(left_lanes[0]) | (_mm_movemask_ps(left_lanes[1]) << 4));
+}
+
+void get_face_indices_of_packet(FrozenTrapezoidGraph const & graph, frm::Point const * points, size_t points_count, size_t * face_indices) noexcept
+{
+    alignas(16) float packet_x[packet_size];
+    alignas(16) float packet_y[packet_size];
+
+    // unused lanes repeat the last point
+    for (size_t i = 0; i < packet_size; ++i)
+    {
+        frm::Point const point = points[std::min(i, points_count - 1)];
+        packet_x[i] = point.x;
+        packet_y[i] = point.y;
+    }
+
+    __m128 const x[2] = { _mm_load_ps(packet_x), _mm_load_ps(packet_x + 4) };
+    __m128 const y[2] = { _mm_load_ps(packet_y), _mm_load_ps(packet_y + 4) };
+
+    FrozenGraphNode const * const nodes = graph.nodes.data();
+
+    // masks of pending subpackets are disjoint, so there are less than packet_size of them
+    std::pair<frozen_graph_reference_t, uint32_t> pending[packet_size];
+    size_t pending_count = 0;
+
+    frozen_graph_reference_t current = graph.root;
+    uint32_t mask = (1u << points_count) - 1;
+
+    while (true)
+    {
+        while (get_frozen_graph_reference_type(current) != GraphNode::Type::Leaf)
+        {
+            FrozenGraphNode const & node = nodes[get_frozen_graph_reference_index(current)];
+
+            uint32_t const left_mask = get_packet_left_mask(node, get_frozen_graph_reference_type(current), x, y) & mask;
+            uint32_t const right_mask = mask & ~left_mask;
+
+            if (right_mask == 0)
+            {
+                current = node.left_child;
+            }
+            else if (left_mask == 0)
+            {
+                current = node.right_child;
+            }
+            else
+            {
+                pending[pending_count++] = { node.right_child, right_mask };
+
+                current = node.left_child;
+                mask = left_mask;
+            }
+        }
+
+        size_t const face_index = get_frozen_graph_reference_index(current);
+
+        for (size_t i = 0; i < points_count; ++i)
+        {
+            if (mask & (1u << i))
+            {
+                face_indices[i] = face_index;
+            }
+        }
+
+        if (pending_count == 0)
+        {
+            return;
+        }
+
+        --pending_count;
+        current = pending[pending_count].first;
+        mask = pending[pending_count].second;
+    }
+}
+
+std::vector<size_t> get_face_indices_by_packets(FrozenTrapezoidGraph const & graph, std::vector<frm::Point> const & points) noexcept
+{
+    std::vector<size_t> face_indices(points.size());
+
+    for (size_t begin = 0; begin < points.size(); begin += packet_size)
+    {
+        size_t const points_count = std::min(packet_size, points.size() - begin);
+
+        get_face_indices_of_packet(graph, points.data() + begin, points_count, face_indices.data() + begin);
+    }
+
+    return face_indices;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+
+#include "trapezoidal_decomposition.h"
+
+
+// reference to node of frozen graph, two low bits are type of node
+// leaves are not stored, reference to leaf contains face index
+using frozen_graph_reference_t = uint32_t;
+
+// 16 bytes, four nodes in cache line
+struct FrozenGraphNode
+{
+    // XUnit - x and unused value, YUnit - k and c of line
+    float first;
+    float second;
+
+    frozen_graph_reference_t left_child;
+    frozen_graph_reference_t right_child;
+};
+
+// query-only copy of search graph, nodes are unique and placed in BFS order
+struct FrozenTrapezoidGraph
+{
+    size_t outside_face;
+
+    frozen_graph_reference_t root;
+    std::vector<FrozenGraphNode> nodes;
+};
+
+
+// O(n)
+FrozenTrapezoidGraph freeze_trapezoid_graph(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG);
+
+// O(log(n))
+size_t get_face_index(FrozenTrapezoidGraph const & graph, frm::Point point) noexcept;
+
+// the same as get_face_index for every point, interleaved queries hide latency of memory
+std::vector<size_t> get_face_indices(FrozenTrapezoidGraph const & graph, std::vector<frm::Point> const & points) noexcept;
+
+// the same as get_face_index for every point, consecutive points are processed in packets
+// packet goes down the graph together and is split only where its points take different branches
+std::vector<size_t> get_face_indices_by_packets(FrozenTrapezoidGraph const & graph, std::vector<frm::Point> const & points) noexcept;
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "trapezoidal_decomposition.h"
+#include "geometry_kernel.h"
 
 #include <set>
 #include <cassert>
 #include <algorithm>
+#include <cmath>
 #include <random>
 #include <iostream>
+#include <thread>
+#include <xmmintrin.h>
 
 
 // first - TrapezoidData
@@ -16,6 +20,14 @@ void output_trapezoid(std::ostream & os, TrapezoidData const & trapezoid_data) n
     {
         Trapezoid const & current_trapezoid = trapezoid_data.trapezoids[i];
         os << i << " : ";
+
+        // record of merged trapezoid which is not reused yet
+        if (current_trapezoid.trapezoid_node == null_graph_node_index)
+        {
+            os << "free\n";
+            continue;
+        }
+
         os << current_trapezoid.top_line_segment_index << " ";
         os << current_trapezoid.bottom_line_segment_index << " | ";
 
@@ -27,95 +39,310 @@ void output_trapezoid(std::ostream & os, TrapezoidData const & trapezoid_data) n
         os << current_trapezoid.top_right_neighbor_index << " ";
         os << current_trapezoid.bottom_right_neighbor_index << " | ";
 
-        os << static_cast<uint16_t>(current_trapezoid.trapezoid_node->type) << " " << current_trapezoid.trapezoid_node->index_by_type << '\n';
+        GraphNode const & trapezoid_node = trapezoid_data.graph_nodes[current_trapezoid.trapezoid_node];
+        os << static_cast<uint16_t>(trapezoid_node.type) << " " << trapezoid_node.index_by_type << '\n';
+    }
+}
+
+void output_tree(std::ostream & os, TrapezoidData const & trapezoid_data, uint32_t node_index, std::string offset) noexcept
+{
+    GraphNode const & node = trapezoid_data.graph_nodes[node_index];
+
+    os << offset << static_cast<uint16_t>(node.type) << " " << node.index_by_type << '\n';
+    if (node.left_child != null_graph_node_index)
+    {
+        output_tree(os, trapezoid_data, node.left_child, offset + "|   ");
+    }
+    if (node.right_child != null_graph_node_index)
+    {
+        output_tree(os, trapezoid_data, node.right_child, offset + "|   ");
     }
 }
 
-void output_tree(std::ostream & os, std::shared_ptr<GraphNode> node, std::string offset) noexcept
+template<>
+uint32_t get_next_graph_node_index<GraphNode::Type::XUnit>(
+    TrapezoidData const & trapezoid_data,
+    GraphNode const & current_node,
+    frm::Point point
+) noexcept
 {
-    os << offset << static_cast<uint16_t>(node->type) << " " << node->index_by_type << '\n';
-    if (node->left_child)
+    frm::Point const current_point = trapezoid_data.ends_of_line_segment[current_node.index_by_type];
+
+    if (is_right_of_vertical_line(point.x, current_point.x, frm::epsilon))
     {
-        output_tree(os, node->left_child, offset + "|   ");
+        return current_node.right_child;
     }
-    if (node->right_child)
+    return current_node.left_child;
+}
+
+template<>
+uint32_t get_next_graph_node_index<GraphNode::Type::YUnit>(
+    TrapezoidData const & trapezoid_data,
+    GraphNode const & current_node,
+    frm::Point point
+) noexcept
+{
+    LineSegment const & line_segment = trapezoid_data.line_segments[current_node.index_by_type];
+
+    if (is_over_line(point.x, point.y, line_segment.k, line_segment.c))
     {
-        output_tree(os, node->right_child, offset + "|   ");
+        return current_node.left_child;
     }
+    return current_node.right_child;
 }
 
-std::shared_ptr<GraphNode> get_trapezoid_index(
+// returns leaf node
+uint32_t get_trapezoid_index(
     TrapezoidData const & trapezoid_data,
-    std::shared_ptr<GraphNode> const & current,
+    uint32_t current,
     frm::Point point
 ) noexcept(!IS_DEBUG)
 {
-    if (current->type == GraphNode::Type::Leaf)
+    GraphNode const * const graph_nodes = trapezoid_data.graph_nodes.data();
+
+    while (true)
     {
-        return current;
+        GraphNode const & current_node = graph_nodes[current];
+
+        if (current_node.type == GraphNode::Type::Leaf)
+        {
+            return current;
+        }
+
+        // both children are loaded while ends of line segment or line segment are loaded
+        _mm_prefetch(reinterpret_cast<char const *>(graph_nodes + current_node.left_child), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<char const *>(graph_nodes + current_node.right_child), _MM_HINT_T0);
+
+        switch (current_node.type)
+        {
+        case GraphNode::Type::XUnit:
+            current = get_next_graph_node_index<GraphNode::Type::XUnit>(trapezoid_data, current_node, point);
+            break;
+        case GraphNode::Type::YUnit:
+            current = get_next_graph_node_index<GraphNode::Type::YUnit>(trapezoid_data, current_node, point);
+            break;
+        default:
+            assert("Undefined graph node type" && false);
+            return 0;
+        }
     }
+}
 
-    if (current->type == GraphNode::Type::XUnit)
+// returns leaf node of trapezoid which contains part of line segment next to its begin or end
+// ends are compared by index and line segments with common end are compared by slope, so no offseted points are needed
+// if line segment is in graph, trapezoid over or under it is returned by is_over
+uint32_t get_line_segment_end_trapezoid_index(
+    TrapezoidData const & trapezoid_data,
+    uint32_t current,
+    uint32_t line_index,
+    bool is_begin,
+    bool is_over
+) noexcept(!IS_DEBUG)
+{
+    LineSegment const & line_segment = trapezoid_data.line_segments[line_index];
+
+    uint32_t const end_index = is_begin ? line_segment.begin_index : line_segment.end_index;
+    frm::Point const point = trapezoid_data.ends_of_line_segment[end_index];
+
+    while (true)
     {
-        frm::Point const current_point = trapezoid_data.ends_of_line_segment[current->index_by_type];
+        GraphNode const & current_node = trapezoid_data.graph_nodes[current];
+
+        switch (current_node.type)
+        {
+        case GraphNode::Type::Leaf:
+            return current;
+        case GraphNode::Type::XUnit:
+        {
+            float const x = trapezoid_data.ends_of_line_segment[current_node.index_by_type].x;
 
-        if (point.x - current_point.x > frm::epsilon)
+            // line segment goes to the right from begin and to the left from end
+            bool const is_right = is_begin ? point.x - x > -frm::epsilon : point.x - x > frm::epsilon;
+
+            current = is_right ? current_node.right_child : current_node.left_child;
+            break;
+        }
+        case GraphNode::Type::YUnit:
         {
-            return get_trapezoid_index(trapezoid_data, current->right_child, point);
+            LineSegment const & other_line_segment = trapezoid_data.line_segments[current_node.index_by_type];
+
+            bool is_over_other;
+            if (current_node.index_by_type == line_index)
+            {
+                is_over_other = is_over;
+            }
+            else if (end_index == other_line_segment.begin_index || end_index == other_line_segment.end_index)
+            {
+                is_over_other = is_begin ? line_segment.k > other_line_segment.k : line_segment.k < other_line_segment.k;
+            }
+            else
+            {
+                is_over_other = frm::is_point_over_line(point, { other_line_segment.k, other_line_segment.c });
+            }
+
+            current = is_over_other ? current_node.left_child : current_node.right_child;
+            break;
+        }
+        default:
+            assert("Undefined graph node type" && false);
+            return 0;
         }
-        return get_trapezoid_index(trapezoid_data, current->left_child, point);
     }
+}
 
-    if (current->type == GraphNode::Type::YUnit)
+// returns leaf node of trapezoid which is over or under line segment at point on it
+// the same as get_trapezoid_index, but line segment itself is not compared with point
+uint32_t get_trapezoid_index_next_to_line_segment(
+    TrapezoidData const & trapezoid_data,
+    uint32_t current,
+    frm::Point point,
+    uint32_t line_index,
+    bool is_over
+) noexcept(!IS_DEBUG)
+{
+    while (true)
     {
-        LineSegment const line_segment_indices = trapezoid_data.line_segments[current->index_by_type];
+        GraphNode const & current_node = trapezoid_data.graph_nodes[current];
 
-        frm::Point const begin_point = trapezoid_data.ends_of_line_segment[line_segment_indices.begin_index];
-        frm::Point const end_point = trapezoid_data.ends_of_line_segment[line_segment_indices.end_index];
+        switch (current_node.type)
+        {
+        case GraphNode::Type::Leaf:
+            return current;
+        case GraphNode::Type::XUnit:
+            current = get_next_graph_node_index<GraphNode::Type::XUnit>(trapezoid_data, current_node, point);
+            break;
+        case GraphNode::Type::YUnit:
+            if (current_node.index_by_type == line_index)
+            {
+                current = is_over ? current_node.left_child : current_node.right_child;
+            }
+            else
+            {
+                current = get_next_graph_node_index<GraphNode::Type::YUnit>(trapezoid_data, current_node, point);
+            }
+            break;
+        default:
+            assert("Undefined graph node type" && false);
+            return 0;
+        }
+    }
+}
 
-        float const k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
-        float const c = end_point.y - k * end_point.x;
+// returns leaf node of trapezoid which contains part of query line segment next to its begin
+// the same as get_line_segment_end_trapezoid_index for line segment which is not in graph,
+// begin on line segment or at its end is compared by slope, so walk from vertex does not start behind it
+uint32_t get_query_line_segment_begin_trapezoid_index(
+    TrapezoidData const & trapezoid_data,
+    uint32_t current,
+    frm::Point begin,
+    frm::Point end
+) noexcept(!IS_DEBUG)
+{
+    while (true)
+    {
+        GraphNode const & current_node = trapezoid_data.graph_nodes[current];
 
-        bool const is_point_over_line = frm::is_point_over_line(point, { k, c });
+        switch (current_node.type)
+        {
+        case GraphNode::Type::Leaf:
+            return current;
+        case GraphNode::Type::XUnit:
+        {
+            float const x = trapezoid_data.ends_of_line_segment[current_node.index_by_type].x;
 
-        if (is_point_over_line)
+            // query line segment goes to the right from begin
+            current = begin.x - x > -frm::epsilon ? current_node.right_child : current_node.left_child;
+            break;
+        }
+        case GraphNode::Type::YUnit:
         {
-            return get_trapezoid_index(trapezoid_data, current->left_child, point);
+            LineSegment const & line_segment = trapezoid_data.line_segments[current_node.index_by_type];
+            frm::Point const line_begin = trapezoid_data.ends_of_line_segment[line_segment.begin_index];
+            frm::Point const line_end = trapezoid_data.ends_of_line_segment[line_segment.end_index];
+
+            int side = get_cross_product_sign(line_begin, line_end, begin);
+            if (side == 0)
+            {
+                side = get_cross_product_sign(line_begin, line_end, begin, end);
+            }
+
+            current = side > 0 ? current_node.left_child : current_node.right_child;
+            break;
         }
-        return get_trapezoid_index(trapezoid_data, current->right_child, point);
+        default:
+            assert("Undefined graph node type" && false);
+            return 0;
+        }
+    }
+}
+
+uint32_t get_free_trapezoid_index(TrapezoidData & trapezoid_data) noexcept
+{
+    uint32_t index;
+
+    if (trapezoid_data.free_trapezoids.empty())
+    {
+        assert(trapezoid_data.trapezoids.size() < null_trapezoid_data_index);
+
+        index = static_cast<uint32_t>(trapezoid_data.trapezoids.size());
+        trapezoid_data.trapezoids.push_back({});
+    }
+    else
+    {
+        index = trapezoid_data.free_trapezoids.back();
+        trapezoid_data.free_trapezoids.pop_back();
     }
 
-    assert("Undefined graph node type" && false);
-    return 0;
+    if (trapezoid_data.build_statistics != nullptr)
+    {
+        ++trapezoid_data.build_statistics->trapezoids_created;
+    }
+
+    return index;
+}
+
+void update_line_segment_coefficients(TrapezoidData const & trapezoid_data, LineSegment & line_segment) noexcept
+{
+    frm::Point const begin_point = trapezoid_data.ends_of_line_segment[line_segment.begin_index];
+    frm::Point const end_point = trapezoid_data.ends_of_line_segment[line_segment.end_index];
+
+    // vertical line segments are not inserted in graph
+    if (abs(begin_point.x - end_point.x) > frm::epsilon)
+    {
+        line_segment.k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
+        line_segment.c = end_point.y - line_segment.k * end_point.x;
+    }
 }
 
-size_t get_free_trapezoid_index(TrapezoidData & trapezoid_data) noexcept
+uint32_t get_free_graph_node_index(TrapezoidData & trapezoid_data) noexcept
 {
-    size_t const index = trapezoid_data.trapezoids.size();
-    trapezoid_data.trapezoids.push_back({});
+    assert(trapezoid_data.graph_nodes.size() < null_graph_node_index);
+
+    uint32_t const index = static_cast<uint32_t>(trapezoid_data.graph_nodes.size());
+    trapezoid_data.graph_nodes.push_back({});
     return index;
 }
 
-void update_famous_neighbors(TrapezoidData & trapezoid_data, size_t trapezoid_index) noexcept
+void update_famous_neighbors(TrapezoidData & trapezoid_data, uint32_t trapezoid_index) noexcept
 {
     Trapezoid const & trapezoid = trapezoid_data.trapezoids[trapezoid_index];
 
-    if (trapezoid.top_left_neighbor_index != std::numeric_limits<size_t>::max())
+    if (trapezoid.top_left_neighbor_index != null_trapezoid_data_index)
     {
         Trapezoid & neighbor_trapezoid = trapezoid_data.trapezoids[trapezoid.top_left_neighbor_index];
         neighbor_trapezoid.top_right_neighbor_index = trapezoid_index;
     }
-    if (trapezoid.bottom_left_neighbor_index != std::numeric_limits<size_t>::max())
+    if (trapezoid.bottom_left_neighbor_index != null_trapezoid_data_index)
     {
         Trapezoid & neighbor_trapezoid = trapezoid_data.trapezoids[trapezoid.bottom_left_neighbor_index];
         neighbor_trapezoid.bottom_right_neighbor_index = trapezoid_index;
     }
-    if (trapezoid.top_right_neighbor_index != std::numeric_limits<size_t>::max())
+    if (trapezoid.top_right_neighbor_index != null_trapezoid_data_index)
     {
         Trapezoid & neighbor_trapezoid = trapezoid_data.trapezoids[trapezoid.top_right_neighbor_index];
         neighbor_trapezoid.top_left_neighbor_index = trapezoid_index;
     }
-    if (trapezoid.bottom_right_neighbor_index != std::numeric_limits<size_t>::max())
+    if (trapezoid.bottom_right_neighbor_index != null_trapezoid_data_index)
     {
         Trapezoid & neighbor_trapezoid = trapezoid_data.trapezoids[trapezoid.bottom_right_neighbor_index];
         neighbor_trapezoid.bottom_left_neighbor_index = trapezoid_index;
@@ -125,22 +352,22 @@ void update_famous_neighbors(TrapezoidData & trapezoid_data, size_t trapezoid_in
 
 void handle_inside_one_trapezoid(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index
+    uint32_t trapezoid,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index
 ) noexcept
 {
-    bool const begin_is_existing_end = trapezoid_data.trapezoids[trapezoid->index_by_type].left_end_index == begin_index;
-    bool const end_is_existing_end = trapezoid_data.trapezoids[trapezoid->index_by_type].right_end_index == end_index;
+    bool const begin_is_existing_end = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[trapezoid].index_by_type].left_end_index == begin_index;
+    bool const end_is_existing_end = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[trapezoid].index_by_type].right_end_index == end_index;
 
     if (begin_is_existing_end && end_is_existing_end)
     {
-        size_t const old_trapezoid_index = trapezoid->index_by_type;
+        uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
         Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-        size_t const top_trapezoid_index = old_trapezoid_index;
-        size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const top_trapezoid_index = old_trapezoid_index;
+        uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
         Trapezoid & top_trapezoid = trapezoid_data.trapezoids[top_trapezoid_index];
         top_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -148,49 +375,49 @@ void handle_inside_one_trapezoid(
         top_trapezoid.left_end_index = begin_index;
         top_trapezoid.right_end_index = end_index;
         top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
-        top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
         top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
         bottom_trapezoid.top_line_segment_index = line_index;
         bottom_trapezoid.bottom_line_segment_index = old_trapezoid.bottom_line_segment_index;
         bottom_trapezoid.left_end_index = begin_index;
         bottom_trapezoid.right_end_index = end_index;
-        bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-        std::shared_ptr<GraphNode> line_node = trapezoid;
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = trapezoid;
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        line_node->left_child = top_trapezoid_node;
-        line_node->right_child = bottom_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
     }
 
     if (begin_is_existing_end && !end_is_existing_end)
     {
-        size_t const old_trapezoid_index = trapezoid->index_by_type;
+        uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
         Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-        size_t const right_trapezoid_index = old_trapezoid_index;
-        size_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
-        size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const right_trapezoid_index = old_trapezoid_index;
+        uint32_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
         Trapezoid & right_trapezoid = trapezoid_data.trapezoids[right_trapezoid_index];
         right_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -208,62 +435,62 @@ void handle_inside_one_trapezoid(
         top_trapezoid.left_end_index = begin_index;
         top_trapezoid.right_end_index = end_index;
         top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
-        top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
         top_trapezoid.top_right_neighbor_index = right_trapezoid_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
         bottom_trapezoid.top_line_segment_index = line_index;
         bottom_trapezoid.bottom_line_segment_index = old_trapezoid.bottom_line_segment_index;
         bottom_trapezoid.left_end_index = begin_index;
         bottom_trapezoid.right_end_index = end_index;
-        bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = right_trapezoid_index;
 
         update_famous_neighbors(trapezoid_data, right_trapezoid_index);
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> right_trapezoid_node = std::make_shared<GraphNode>();
-        right_trapezoid_node->type = GraphNode::Type::Leaf;
-        right_trapezoid_node->index_by_type = right_trapezoid_index;
+        uint32_t const right_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[right_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[right_trapezoid_node].index_by_type = right_trapezoid_index;
         right_trapezoid.trapezoid_node = right_trapezoid_node;
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-        std::shared_ptr<GraphNode> end_node = trapezoid;
-        end_node->type = GraphNode::Type::XUnit;
-        end_node->index_by_type = end_index;
+        uint32_t const end_node = trapezoid;
+        trapezoid_data.graph_nodes[end_node].type = GraphNode::Type::XUnit;
+        trapezoid_data.graph_nodes[end_node].index_by_type = end_index;
 
-        std::shared_ptr<GraphNode> line_node = std::make_shared<GraphNode>();
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        end_node->left_child = line_node;
-        end_node->right_child = right_trapezoid_node;
+        trapezoid_data.graph_nodes[end_node].left_child = line_node;
+        trapezoid_data.graph_nodes[end_node].right_child = right_trapezoid_node;
 
-        line_node->left_child = top_trapezoid_node;
-        line_node->right_child = bottom_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
     }
 
     if (!begin_is_existing_end && end_is_existing_end)
     {
-        size_t const old_trapezoid_index = trapezoid->index_by_type;
+        uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
         Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-        size_t const left_trapezoid_index = old_trapezoid_index;
-        size_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
-        size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const left_trapezoid_index = old_trapezoid_index;
+        uint32_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
         Trapezoid & left_trapezoid = trapezoid_data.trapezoids[left_trapezoid_index];
         left_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -281,63 +508,63 @@ void handle_inside_one_trapezoid(
         top_trapezoid.left_end_index = begin_index;
         top_trapezoid.right_end_index = end_index;
         top_trapezoid.top_left_neighbor_index = left_trapezoid_index;
-        top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
         top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
         bottom_trapezoid.top_line_segment_index = line_index;
         bottom_trapezoid.bottom_line_segment_index = old_trapezoid.bottom_line_segment_index;
         bottom_trapezoid.left_end_index = begin_index;
         bottom_trapezoid.right_end_index = end_index;
-        bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_left_neighbor_index = left_trapezoid_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
         update_famous_neighbors(trapezoid_data, left_trapezoid_index);
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> left_trapezoid_node = std::make_shared<GraphNode>();
-        left_trapezoid_node->type = GraphNode::Type::Leaf;
-        left_trapezoid_node->index_by_type = left_trapezoid_index;
+        uint32_t const left_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[left_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[left_trapezoid_node].index_by_type = left_trapezoid_index;
         left_trapezoid.trapezoid_node = left_trapezoid_node;
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-        std::shared_ptr<GraphNode> begin_node = trapezoid;
-        begin_node->type = GraphNode::Type::XUnit;
-        begin_node->index_by_type = begin_index;
+        uint32_t const begin_node = trapezoid;
+        trapezoid_data.graph_nodes[begin_node].type = GraphNode::Type::XUnit;
+        trapezoid_data.graph_nodes[begin_node].index_by_type = begin_index;
 
-        std::shared_ptr<GraphNode> line_node = std::make_shared<GraphNode>();
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        begin_node->left_child = left_trapezoid_node;
-        begin_node->right_child = line_node;
+        trapezoid_data.graph_nodes[begin_node].left_child = left_trapezoid_node;
+        trapezoid_data.graph_nodes[begin_node].right_child = line_node;
 
-        line_node->left_child = top_trapezoid_node;
-        line_node->right_child = bottom_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
     }
 
     if (!begin_is_existing_end && !end_is_existing_end)
     {
-        size_t const old_trapezoid_index = trapezoid->index_by_type;
+        uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
         Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-        size_t const left_trapezoid_index = old_trapezoid_index;
-        size_t const right_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
-        size_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
-        size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const left_trapezoid_index = old_trapezoid_index;
+        uint32_t const right_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+        uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
         Trapezoid & left_trapezoid = trapezoid_data.trapezoids[left_trapezoid_index];
         left_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -365,18 +592,18 @@ void handle_inside_one_trapezoid(
         top_trapezoid.left_end_index = begin_index;
         top_trapezoid.right_end_index = end_index;
         top_trapezoid.top_left_neighbor_index = left_trapezoid_index;
-        top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
         top_trapezoid.top_right_neighbor_index = right_trapezoid_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
         bottom_trapezoid.top_line_segment_index = line_index;
         bottom_trapezoid.bottom_line_segment_index = old_trapezoid.bottom_line_segment_index;
         bottom_trapezoid.left_end_index = begin_index;
         bottom_trapezoid.right_end_index = end_index;
-        bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_left_neighbor_index = left_trapezoid_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = right_trapezoid_index;
 
         update_famous_neighbors(trapezoid_data, left_trapezoid_index);
@@ -384,65 +611,65 @@ void handle_inside_one_trapezoid(
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> left_trapezoid_node = std::make_shared<GraphNode>();
-        left_trapezoid_node->type = GraphNode::Type::Leaf;
-        left_trapezoid_node->index_by_type = left_trapezoid_index;
+        uint32_t const left_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[left_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[left_trapezoid_node].index_by_type = left_trapezoid_index;
         left_trapezoid.trapezoid_node = left_trapezoid_node;
 
-        std::shared_ptr<GraphNode> right_trapezoid_node = std::make_shared<GraphNode>();
-        right_trapezoid_node->type = GraphNode::Type::Leaf;
-        right_trapezoid_node->index_by_type = right_trapezoid_index;
+        uint32_t const right_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[right_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[right_trapezoid_node].index_by_type = right_trapezoid_index;
         right_trapezoid.trapezoid_node = right_trapezoid_node;
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-        std::shared_ptr<GraphNode> begin_node = trapezoid;
-        begin_node->type = GraphNode::Type::XUnit;
-        begin_node->index_by_type = begin_index;
+        uint32_t const begin_node = trapezoid;
+        trapezoid_data.graph_nodes[begin_node].type = GraphNode::Type::XUnit;
+        trapezoid_data.graph_nodes[begin_node].index_by_type = begin_index;
 
-        std::shared_ptr<GraphNode> end_node = std::make_shared<GraphNode>();
-        end_node->type = GraphNode::Type::XUnit;
-        end_node->index_by_type = end_index;
+        uint32_t const end_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[end_node].type = GraphNode::Type::XUnit;
+        trapezoid_data.graph_nodes[end_node].index_by_type = end_index;
 
-        std::shared_ptr<GraphNode> line_node = std::make_shared<GraphNode>();
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        begin_node->left_child = left_trapezoid_node;
-        begin_node->right_child = end_node;
+        trapezoid_data.graph_nodes[begin_node].left_child = left_trapezoid_node;
+        trapezoid_data.graph_nodes[begin_node].right_child = end_node;
 
-        end_node->left_child = line_node;
-        end_node->right_child = right_trapezoid_node;
+        trapezoid_data.graph_nodes[end_node].left_child = line_node;
+        trapezoid_data.graph_nodes[end_node].right_child = right_trapezoid_node;
 
-        line_node->left_child = top_trapezoid_node;
-        line_node->right_child = bottom_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
     }
 }
 
 void handle_first_trapezoid_with_existing_vertex(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    std::shared_ptr<GraphNode> & last_top_node,
-    std::shared_ptr<GraphNode> & last_bottom_node,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index,
+    uint32_t trapezoid,
+    uint32_t & last_top_node,
+    uint32_t & last_bottom_node,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index,
     bool is_right_end_of_begin_trapezoid_over_line
 ) noexcept
 {
-    size_t const old_trapezoid_index = trapezoid->index_by_type;
+    uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
     Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-    size_t const top_trapezoid_index = old_trapezoid_index;
-    size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+    uint32_t const top_trapezoid_index = old_trapezoid_index;
+    uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
     Trapezoid & top_trapezoid = trapezoid_data.trapezoids[top_trapezoid_index];
     top_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -453,9 +680,9 @@ void handle_first_trapezoid_with_existing_vertex(
         top_trapezoid.right_end_index = old_trapezoid.right_end_index;
     }
     top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
-    top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
     top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-    top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
     Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
     bottom_trapezoid.top_line_segment_index = line_index;
@@ -465,30 +692,30 @@ void handle_first_trapezoid_with_existing_vertex(
     {
         bottom_trapezoid.right_end_index = old_trapezoid.right_end_index;
     }
-    bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-    bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
     update_famous_neighbors(trapezoid_data, top_trapezoid_index);
     update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-    std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-    top_trapezoid_node->type = GraphNode::Type::Leaf;
-    top_trapezoid_node->index_by_type = top_trapezoid_index;
+    uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
     top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-    std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-    bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-    bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+    uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
     bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-    std::shared_ptr<GraphNode> line_node = trapezoid;
-    line_node->type = GraphNode::Type::YUnit;
-    line_node->index_by_type = line_index;
+    uint32_t const line_node = trapezoid;
+    trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+    trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-    line_node->left_child = top_trapezoid_node;
-    line_node->right_child = bottom_trapezoid_node;
+    trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+    trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
 
     last_top_node = top_trapezoid_node;
     last_bottom_node = bottom_trapezoid_node;
@@ -496,21 +723,21 @@ void handle_first_trapezoid_with_existing_vertex(
 
 void handle_first_trapezoid_without_existing_vertex(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    std::shared_ptr<GraphNode> & last_top_node,
-    std::shared_ptr<GraphNode> & last_bottom_node,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index,
+    uint32_t trapezoid,
+    uint32_t & last_top_node,
+    uint32_t & last_bottom_node,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index,
     bool is_right_end_of_begin_trapezoid_over_line
 ) noexcept
 {
-    size_t const old_trapezoid_index = trapezoid->index_by_type;
+    uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
     Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-    size_t const left_trapezoid_index = old_trapezoid_index;
-    size_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
-    size_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+    uint32_t const left_trapezoid_index = old_trapezoid_index;
+    uint32_t const top_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+    uint32_t const bottom_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
     Trapezoid & left_trapezoid = trapezoid_data.trapezoids[left_trapezoid_index];
     left_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -531,9 +758,9 @@ void handle_first_trapezoid_without_existing_vertex(
         top_trapezoid.right_end_index = old_trapezoid.right_end_index;
     }
     top_trapezoid.top_left_neighbor_index = left_trapezoid_index;
-    top_trapezoid.bottom_left_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_left_neighbor_index = null_trapezoid_data_index;
     top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-    top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
     Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
     bottom_trapezoid.top_line_segment_index = line_index;
@@ -543,43 +770,43 @@ void handle_first_trapezoid_without_existing_vertex(
     {
         bottom_trapezoid.right_end_index = old_trapezoid.right_end_index;
     }
-    bottom_trapezoid.top_left_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_left_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_left_neighbor_index = left_trapezoid_index;
-    bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
     update_famous_neighbors(trapezoid_data, left_trapezoid_index);
     update_famous_neighbors(trapezoid_data, top_trapezoid_index);
     update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-    std::shared_ptr<GraphNode> left_trapezoid_node = std::make_shared<GraphNode>();
-    left_trapezoid_node->type = GraphNode::Type::Leaf;
-    left_trapezoid_node->index_by_type = left_trapezoid_index;
+    uint32_t const left_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[left_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[left_trapezoid_node].index_by_type = left_trapezoid_index;
     left_trapezoid.trapezoid_node = left_trapezoid_node;
 
-    std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-    top_trapezoid_node->type = GraphNode::Type::Leaf;
-    top_trapezoid_node->index_by_type = top_trapezoid_index;
+    uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
     top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-    std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-    bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-    bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+    uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
     bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-    std::shared_ptr<GraphNode> begin_node = trapezoid;
-    begin_node->type = GraphNode::Type::XUnit;
-    begin_node->index_by_type = begin_index;
+    uint32_t const begin_node = trapezoid;
+    trapezoid_data.graph_nodes[begin_node].type = GraphNode::Type::XUnit;
+    trapezoid_data.graph_nodes[begin_node].index_by_type = begin_index;
 
-    std::shared_ptr<GraphNode> line_node = std::make_shared<GraphNode>();
-    line_node->type = GraphNode::Type::YUnit;
-    line_node->index_by_type = line_index;
+    uint32_t const line_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+    trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-    begin_node->left_child = left_trapezoid_node;
-    begin_node->right_child = line_node;
+    trapezoid_data.graph_nodes[begin_node].left_child = left_trapezoid_node;
+    trapezoid_data.graph_nodes[begin_node].right_child = line_node;
 
-    line_node->left_child = top_trapezoid_node;
-    line_node->right_child = bottom_trapezoid_node;
+    trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+    trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
 
     last_top_node = top_trapezoid_node;
     last_bottom_node = bottom_trapezoid_node;
@@ -588,29 +815,29 @@ void handle_first_trapezoid_without_existing_vertex(
 
 void handle_middle_trapezoid(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    std::shared_ptr<GraphNode> & last_top_node,
-    std::shared_ptr<GraphNode> & last_bottom_node,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index,
+    uint32_t trapezoid,
+    uint32_t & last_top_node,
+    uint32_t & last_bottom_node,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index,
     bool is_last_point_over_line,
     bool is_current_point_over_line
 ) noexcept
 {
-    size_t const old_trapezoid_index = trapezoid->index_by_type;
+    uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
     Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
-    size_t const last_top_trapezoid_index = last_top_node->index_by_type;
-    size_t const last_bottom_trapezoid_index = last_bottom_node->index_by_type;
+    uint32_t const last_top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+    uint32_t const last_bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
 
     Trapezoid & last_top_trapezoid = trapezoid_data.trapezoids[last_top_trapezoid_index];
     Trapezoid & last_bottom_trapezoid = trapezoid_data.trapezoids[last_bottom_trapezoid_index];
 
     if (is_last_point_over_line)
     {
-        size_t const last_top_trapezoid_index = last_top_node->index_by_type;
-        size_t const top_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+        uint32_t const top_trapezoid_index = old_trapezoid_index;
 
         last_top_trapezoid.right_end_index = old_trapezoid.left_end_index;
         last_top_trapezoid.bottom_right_neighbor_index = top_trapezoid_index;
@@ -631,29 +858,29 @@ void handle_middle_trapezoid(
         top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
         top_trapezoid.bottom_left_neighbor_index = last_top_trapezoid_index;
         top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         update_famous_neighbors(trapezoid_data, last_top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
-        std::shared_ptr<GraphNode> line_node = trapezoid;
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = trapezoid;
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        line_node->left_child = top_trapezoid_node;
-        line_node->right_child = last_bottom_node;
+        trapezoid_data.graph_nodes[line_node].left_child = top_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].right_child = last_bottom_node;
 
         last_top_node = top_trapezoid_node;
     }
     else
     {
-        size_t const last_bottom_trapezoid_index = last_bottom_node->index_by_type;
-        size_t const bottom_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
+        uint32_t const bottom_trapezoid_index = old_trapezoid_index;
 
         last_bottom_trapezoid.right_end_index = old_trapezoid.left_end_index;
         last_bottom_trapezoid.top_right_neighbor_index = bottom_trapezoid_index;
@@ -673,23 +900,23 @@ void handle_middle_trapezoid(
         }
         bottom_trapezoid.top_left_neighbor_index = last_bottom_trapezoid_index;
         bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
         update_famous_neighbors(trapezoid_data, last_bottom_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
-        std::shared_ptr<GraphNode> line_node = trapezoid;
-        line_node->type = GraphNode::Type::YUnit;
-        line_node->index_by_type = line_index;
+        uint32_t const line_node = trapezoid;
+        trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+        trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-        line_node->left_child = last_top_node;
-        line_node->right_child = bottom_trapezoid_node;
+        trapezoid_data.graph_nodes[line_node].left_child = last_top_node;
+        trapezoid_data.graph_nodes[line_node].right_child = bottom_trapezoid_node;
 
         last_bottom_node = bottom_trapezoid_node;
     }
@@ -697,22 +924,22 @@ void handle_middle_trapezoid(
 
 void handle_last_trapezoid_with_existing_vertex(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    std::shared_ptr<GraphNode> & last_top_node,
-    std::shared_ptr<GraphNode> & last_bottom_node,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index,
+    uint32_t trapezoid,
+    uint32_t & last_top_node,
+    uint32_t & last_bottom_node,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index,
     bool is_last_point_over_line
 ) noexcept
 {
-    size_t const old_trapezoid_index = trapezoid->index_by_type;
+    uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
     Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
     if (is_last_point_over_line)
     {
-        size_t const last_top_trapezoid_index = last_top_node->index_by_type;
-        size_t const top_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+        uint32_t const top_trapezoid_index = old_trapezoid_index;
 
         Trapezoid & last_top_trapezoid = trapezoid_data.trapezoids[last_top_trapezoid_index];
         last_top_trapezoid.right_end_index = old_trapezoid.left_end_index;
@@ -726,22 +953,22 @@ void handle_last_trapezoid_with_existing_vertex(
         top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
         top_trapezoid.bottom_left_neighbor_index = last_top_trapezoid_index;
         top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         update_famous_neighbors(trapezoid_data, last_top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
         last_top_node = top_trapezoid_node;
     }
     else
     {
-        size_t const last_bottom_trapezoid_index = last_bottom_node->index_by_type;
-        size_t const bottom_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
+        uint32_t const bottom_trapezoid_index = old_trapezoid_index;
 
         Trapezoid & last_bottom_trapezoid = trapezoid_data.trapezoids[last_bottom_trapezoid_index];
         last_bottom_trapezoid.right_end_index = old_trapezoid.left_end_index;
@@ -754,62 +981,62 @@ void handle_last_trapezoid_with_existing_vertex(
         bottom_trapezoid.right_end_index = end_index;
         bottom_trapezoid.top_left_neighbor_index = last_bottom_trapezoid_index;
         bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
         update_famous_neighbors(trapezoid_data, last_bottom_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
         last_bottom_node = bottom_trapezoid_node;
     }
 
-    size_t const top_trapezoid_index = last_top_node->index_by_type;
-    size_t const bottom_trapezoid_index = last_bottom_node->index_by_type;
+    uint32_t const top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+    uint32_t const bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
 
     Trapezoid & top_trapezoid = trapezoid_data.trapezoids[top_trapezoid_index];
     top_trapezoid.right_end_index = end_index;
     top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-    top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
     Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
     bottom_trapezoid.right_end_index = end_index;
-    bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
     update_famous_neighbors(trapezoid_data, top_trapezoid_index);
     update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-    std::shared_ptr<GraphNode> line_node = trapezoid;
-    line_node->type = GraphNode::Type::YUnit;
-    line_node->index_by_type = line_index;
+    uint32_t const line_node = trapezoid;
+    trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+    trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-    line_node->left_child = last_top_node;
-    line_node->right_child = last_bottom_node;
+    trapezoid_data.graph_nodes[line_node].left_child = last_top_node;
+    trapezoid_data.graph_nodes[line_node].right_child = last_bottom_node;
 }
 
 void handle_last_trapezoid_without_existing_vertex(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> trapezoid,
-    std::shared_ptr<GraphNode> & last_top_node,
-    std::shared_ptr<GraphNode> & last_bottom_node,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index,
+    uint32_t trapezoid,
+    uint32_t & last_top_node,
+    uint32_t & last_bottom_node,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index,
     bool is_last_point_over_line
 ) noexcept
 {
-    size_t const old_trapezoid_index = trapezoid->index_by_type;
+    uint32_t const old_trapezoid_index = trapezoid_data.graph_nodes[trapezoid].index_by_type;
     Trapezoid const old_trapezoid = trapezoid_data.trapezoids[old_trapezoid_index];
 
     if (is_last_point_over_line)
     {
-        size_t const last_top_trapezoid_index = last_top_node->index_by_type;
-        size_t const top_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+        uint32_t const top_trapezoid_index = old_trapezoid_index;
 
         Trapezoid & last_top_trapezoid = trapezoid_data.trapezoids[last_top_trapezoid_index];
         last_top_trapezoid.right_end_index = old_trapezoid.left_end_index;
@@ -823,22 +1050,22 @@ void handle_last_trapezoid_without_existing_vertex(
         top_trapezoid.top_left_neighbor_index = old_trapezoid.top_left_neighbor_index;
         top_trapezoid.bottom_left_neighbor_index = last_top_trapezoid_index;
         top_trapezoid.top_right_neighbor_index = old_trapezoid.top_right_neighbor_index;
-        top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+        top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
         update_famous_neighbors(trapezoid_data, last_top_trapezoid_index);
         update_famous_neighbors(trapezoid_data, top_trapezoid_index);
 
-        std::shared_ptr<GraphNode> top_trapezoid_node = std::make_shared<GraphNode>();
-        top_trapezoid_node->type = GraphNode::Type::Leaf;
-        top_trapezoid_node->index_by_type = top_trapezoid_index;
+        uint32_t const top_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[top_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[top_trapezoid_node].index_by_type = top_trapezoid_index;
         top_trapezoid.trapezoid_node = top_trapezoid_node;
 
         last_top_node = top_trapezoid_node;
     }
     else
     {
-        size_t const last_bottom_trapezoid_index = last_bottom_node->index_by_type;
-        size_t const bottom_trapezoid_index = old_trapezoid_index;
+        uint32_t const last_bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
+        uint32_t const bottom_trapezoid_index = old_trapezoid_index;
 
         Trapezoid & last_bottom_trapezoid = trapezoid_data.trapezoids[last_bottom_trapezoid_index];
         last_bottom_trapezoid.right_end_index = old_trapezoid.left_end_index;
@@ -851,23 +1078,23 @@ void handle_last_trapezoid_without_existing_vertex(
         bottom_trapezoid.right_end_index = end_index;
         bottom_trapezoid.top_left_neighbor_index = last_bottom_trapezoid_index;
         bottom_trapezoid.bottom_left_neighbor_index = old_trapezoid.bottom_left_neighbor_index;
-        bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+        bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
         bottom_trapezoid.bottom_right_neighbor_index = old_trapezoid.bottom_right_neighbor_index;
 
         update_famous_neighbors(trapezoid_data, last_bottom_trapezoid_index);
         update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-        std::shared_ptr<GraphNode> bottom_trapezoid_node = std::make_shared<GraphNode>();
-        bottom_trapezoid_node->type = GraphNode::Type::Leaf;
-        bottom_trapezoid_node->index_by_type = bottom_trapezoid_index;
+        uint32_t const bottom_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[bottom_trapezoid_node].index_by_type = bottom_trapezoid_index;
         bottom_trapezoid.trapezoid_node = bottom_trapezoid_node;
 
         last_bottom_node = bottom_trapezoid_node;
     }
 
-    size_t const top_trapezoid_index = last_top_node->index_by_type;
-    size_t const bottom_trapezoid_index = last_bottom_node->index_by_type;
-    size_t const right_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
+    uint32_t const top_trapezoid_index = trapezoid_data.graph_nodes[last_top_node].index_by_type;
+    uint32_t const bottom_trapezoid_index = trapezoid_data.graph_nodes[last_bottom_node].index_by_type;
+    uint32_t const right_trapezoid_index = get_free_trapezoid_index(trapezoid_data);
 
     Trapezoid & right_trapezoid = trapezoid_data.trapezoids[right_trapezoid_index];
     right_trapezoid.top_line_segment_index = old_trapezoid.top_line_segment_index;
@@ -882,339 +1109,1333 @@ void handle_last_trapezoid_without_existing_vertex(
     Trapezoid & top_trapezoid = trapezoid_data.trapezoids[top_trapezoid_index];
     top_trapezoid.right_end_index = end_index;
     top_trapezoid.top_right_neighbor_index = right_trapezoid_index;
-    top_trapezoid.bottom_right_neighbor_index = std::numeric_limits<size_t>::max();
+    top_trapezoid.bottom_right_neighbor_index = null_trapezoid_data_index;
 
     Trapezoid & bottom_trapezoid = trapezoid_data.trapezoids[bottom_trapezoid_index];
     bottom_trapezoid.right_end_index = end_index;
-    bottom_trapezoid.top_right_neighbor_index = std::numeric_limits<size_t>::max();
+    bottom_trapezoid.top_right_neighbor_index = null_trapezoid_data_index;
     bottom_trapezoid.bottom_right_neighbor_index = right_trapezoid_index;
 
     update_famous_neighbors(trapezoid_data, right_trapezoid_index);
     update_famous_neighbors(trapezoid_data, top_trapezoid_index);
     update_famous_neighbors(trapezoid_data, bottom_trapezoid_index);
 
-    std::shared_ptr<GraphNode> right_trapezoid_node = std::make_shared<GraphNode>();
-    right_trapezoid_node->type = GraphNode::Type::Leaf;
-    right_trapezoid_node->index_by_type = right_trapezoid_index;
+    uint32_t const right_trapezoid_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[right_trapezoid_node].type = GraphNode::Type::Leaf;
+    trapezoid_data.graph_nodes[right_trapezoid_node].index_by_type = right_trapezoid_index;
     right_trapezoid.trapezoid_node = right_trapezoid_node;
 
-    std::shared_ptr<GraphNode> end_node = trapezoid;
-    end_node->type = GraphNode::Type::XUnit;
-    end_node->index_by_type = end_index;
+    uint32_t const end_node = trapezoid;
+    trapezoid_data.graph_nodes[end_node].type = GraphNode::Type::XUnit;
+    trapezoid_data.graph_nodes[end_node].index_by_type = end_index;
+
+    uint32_t const line_node = get_free_graph_node_index(trapezoid_data);
+    trapezoid_data.graph_nodes[line_node].type = GraphNode::Type::YUnit;
+    trapezoid_data.graph_nodes[line_node].index_by_type = line_index;
 
-    std::shared_ptr<GraphNode> line_node = std::make_shared<GraphNode>();
-    line_node->type = GraphNode::Type::YUnit;
-    line_node->index_by_type = line_index;
+    trapezoid_data.graph_nodes[end_node].left_child = line_node;
+    trapezoid_data.graph_nodes[end_node].right_child = right_trapezoid_node;
 
-    end_node->left_child = line_node;
-    end_node->right_child = right_trapezoid_node;
+    trapezoid_data.graph_nodes[line_node].left_child = last_top_node;
+    trapezoid_data.graph_nodes[line_node].right_child = last_bottom_node;
+}
+
+// handler is called directly if statistics are not collected
+template<typename Function>
+void call_handler(TrapezoidData & trapezoid_data, TrapezoidBuildStatistics::Handler handler, Function const & function) noexcept(!IS_DEBUG)
+{
+    TrapezoidBuildStatistics * const statistics = trapezoid_data.build_statistics;
+
+    if (statistics == nullptr)
+    {
+        function();
+        return;
+    }
+
+    auto const begin = std::chrono::steady_clock::now();
+    function();
+    auto const end = std::chrono::steady_clock::now();
+
+    size_t const handler_index = static_cast<size_t>(handler);
 
-    line_node->left_child = last_top_node;
-    line_node->right_child = last_bottom_node;
+    ++statistics->handler_calls[handler_index];
+    statistics->handler_times[handler_index] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+
+    // destroyed trapezoid is replaced in place
+    ++statistics->trapezoids_created;
+    ++statistics->trapezoids_destroyed;
 }
 
 void handle_between_trapezoids(
     TrapezoidData & trapezoid_data,
-    std::shared_ptr<GraphNode> begin_trapezoid,
-    std::shared_ptr<GraphNode> end_trapezoid,
-    size_t begin_index,
-    size_t end_index,
-    size_t line_index
+    uint32_t begin_trapezoid,
+    uint32_t end_trapezoid,
+    uint32_t begin_index,
+    uint32_t end_index,
+    uint32_t line_index
 ) noexcept
 {
-    std::shared_ptr<GraphNode> last_top_node;
-    std::shared_ptr<GraphNode> last_bottom_node;
-
-    frm::Point const begin_point = trapezoid_data.ends_of_line_segment[begin_index];
-    frm::Point const end_point = trapezoid_data.ends_of_line_segment[end_index];
+    uint32_t last_top_node = null_graph_node_index;
+    uint32_t last_bottom_node = null_graph_node_index;
 
-    float const k = (end_point.y - begin_point.y) / (end_point.x - begin_point.x);
-    float const c = end_point.y - k * end_point.x;
+    float const k = trapezoid_data.line_segments[line_index].k;
+    float const c = trapezoid_data.line_segments[line_index].c;
 
     bool const is_right_end_of_begin_trapezoid_over_line = frm::is_point_over_line(
-        trapezoid_data.ends_of_line_segment[trapezoid_data.trapezoids[begin_trapezoid->index_by_type].right_end_index],
+        trapezoid_data.ends_of_line_segment[trapezoid_data.trapezoids[trapezoid_data.graph_nodes[begin_trapezoid].index_by_type].right_end_index],
         { k, c }
     );
 
-    std::shared_ptr<GraphNode> next_node;
+    uint32_t next_node = null_graph_node_index;
 
     if (is_right_end_of_begin_trapezoid_over_line)
     {
-        size_t const bottom_right_neighbor_index = trapezoid_data.trapezoids[begin_trapezoid->index_by_type].bottom_right_neighbor_index;
+        uint32_t const bottom_right_neighbor_index = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[begin_trapezoid].index_by_type].bottom_right_neighbor_index;
         next_node = trapezoid_data.trapezoids[bottom_right_neighbor_index].trapezoid_node;
     }
     else
     {
-        size_t const top_right_neighbor_index = trapezoid_data.trapezoids[begin_trapezoid->index_by_type].top_right_neighbor_index;
+        uint32_t const top_right_neighbor_index = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[begin_trapezoid].index_by_type].top_right_neighbor_index;
         next_node = trapezoid_data.trapezoids[top_right_neighbor_index].trapezoid_node;
     }
 
     // connect to existing
-    if (trapezoid_data.trapezoids[begin_trapezoid->index_by_type].left_end_index == begin_index)
+    if (trapezoid_data.trapezoids[trapezoid_data.graph_nodes[begin_trapezoid].index_by_type].left_end_index == begin_index)
     {
-        handle_first_trapezoid_with_existing_vertex(
-            trapezoid_data,
-            begin_trapezoid,
-            last_top_node,
-            last_bottom_node,
-            begin_index,
-            end_index,
-            line_index,
-            is_right_end_of_begin_trapezoid_over_line
-        );
+        call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::FirstTrapezoidWithExistingVertex, [&]() noexcept(!IS_DEBUG)
+            {
+                handle_first_trapezoid_with_existing_vertex(
+                    trapezoid_data,
+                    begin_trapezoid,
+                    last_top_node,
+                    last_bottom_node,
+                    begin_index,
+                    end_index,
+                    line_index,
+                    is_right_end_of_begin_trapezoid_over_line
+                );
+            });
     }
     else
     {
-        handle_first_trapezoid_without_existing_vertex(
-            trapezoid_data, begin_trapezoid,
-            last_top_node, last_bottom_node,
-            begin_index, end_index,
-            line_index,
-            is_right_end_of_begin_trapezoid_over_line
-        );
+        call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::FirstTrapezoidWithoutExistingVertex, [&]() noexcept(!IS_DEBUG)
+            {
+                handle_first_trapezoid_without_existing_vertex(
+                    trapezoid_data, begin_trapezoid,
+                    last_top_node, last_bottom_node,
+                    begin_index, end_index,
+                    line_index,
+                    is_right_end_of_begin_trapezoid_over_line
+                );
+            });
     }
 
     bool is_last_point_over_line = is_right_end_of_begin_trapezoid_over_line;
 
     while (next_node != end_trapezoid)
     {
-        std::shared_ptr<GraphNode> current_trapezoid = next_node;
+        uint32_t const current_trapezoid = next_node;
         bool const is_current_point_over_line = frm::is_point_over_line(
-            trapezoid_data.ends_of_line_segment[trapezoid_data.trapezoids[current_trapezoid->index_by_type].right_end_index],
+            trapezoid_data.ends_of_line_segment[trapezoid_data.trapezoids[trapezoid_data.graph_nodes[current_trapezoid].index_by_type].right_end_index],
             { k, c }
         );
 
         if (is_current_point_over_line)
         {
-            size_t const bottom_right_neighbor_index = trapezoid_data.trapezoids[current_trapezoid->index_by_type].bottom_right_neighbor_index;
+            uint32_t const bottom_right_neighbor_index = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[current_trapezoid].index_by_type].bottom_right_neighbor_index;
             next_node = trapezoid_data.trapezoids[bottom_right_neighbor_index].trapezoid_node;
         }
         else
         {
-            size_t const top_right_neighbor_index = trapezoid_data.trapezoids[current_trapezoid->index_by_type].top_right_neighbor_index;
+            uint32_t const top_right_neighbor_index = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[current_trapezoid].index_by_type].top_right_neighbor_index;
             next_node = trapezoid_data.trapezoids[top_right_neighbor_index].trapezoid_node;
         }
 
-        handle_middle_trapezoid(
-            trapezoid_data,
-            current_trapezoid,
-            last_top_node,
-            last_bottom_node,
-            begin_index,
-            end_index,
-            line_index,
-            is_last_point_over_line,
-            is_current_point_over_line
-        );
+        call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::MiddleTrapezoid, [&]() noexcept(!IS_DEBUG)
+            {
+                handle_middle_trapezoid(
+                    trapezoid_data,
+                    current_trapezoid,
+                    last_top_node,
+                    last_bottom_node,
+                    begin_index,
+                    end_index,
+                    line_index,
+                    is_last_point_over_line,
+                    is_current_point_over_line
+                );
+            });
         is_last_point_over_line = is_current_point_over_line;
     }
 
     // connect to existing
-    if (trapezoid_data.trapezoids[end_trapezoid->index_by_type].right_end_index == end_index)
+    if (trapezoid_data.trapezoids[trapezoid_data.graph_nodes[end_trapezoid].index_by_type].right_end_index == end_index)
     {
-        handle_last_trapezoid_with_existing_vertex(
-            trapezoid_data,
-            end_trapezoid,
-            last_top_node,
-            last_bottom_node,
-            begin_index,
-            end_index,
-            line_index,
-            is_last_point_over_line
-        );
+        call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::LastTrapezoidWithExistingVertex, [&]() noexcept(!IS_DEBUG)
+            {
+                handle_last_trapezoid_with_existing_vertex(
+                    trapezoid_data,
+                    end_trapezoid,
+                    last_top_node,
+                    last_bottom_node,
+                    begin_index,
+                    end_index,
+                    line_index,
+                    is_last_point_over_line
+                );
+            });
     }
     else
     {
-        handle_last_trapezoid_without_existing_vertex(
-            trapezoid_data,
-            end_trapezoid,
-            last_top_node,
-            last_bottom_node,
-            begin_index,
-            end_index,
-            line_index,
-            is_last_point_over_line
-        );
+        call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::LastTrapezoidWithoutExistingVertex, [&]() noexcept(!IS_DEBUG)
+            {
+                handle_last_trapezoid_without_existing_vertex(
+                    trapezoid_data,
+                    end_trapezoid,
+                    last_top_node,
+                    last_bottom_node,
+                    begin_index,
+                    end_index,
+                    line_index,
+                    is_last_point_over_line
+                );
+            });
     }
 }
 
-trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG)
+void insert_line_segment_in_graph(TrapezoidData & trapezoid_data, uint32_t root, uint32_t line_index) noexcept(!IS_DEBUG)
 {
-    TrapezoidData trapezoid_data{};
-    std::shared_ptr<GraphNode> root;
+    uint32_t const begin_index = trapezoid_data.line_segments[line_index].begin_index;
+    uint32_t const end_index = trapezoid_data.line_segments[line_index].end_index;
 
-    size_t const outside_face_index = frm::dcel::get_outside_face_index(dcel);
+    frm::Point const begin = trapezoid_data.ends_of_line_segment[begin_index];
+    frm::Point const end = trapezoid_data.ends_of_line_segment[end_index];
 
-    // convert dcel to trapezoid data
+    // vertical line segments are not inserted in graph
+    if (abs(begin.x - end.x) > frm::epsilon)
     {
-        trapezoid_data.ends_of_line_segment.resize(dcel.vertices.size());
-        for (size_t i = 0; i < dcel.vertices.size(); ++i)
+        uint32_t const begin_trapezoid = get_line_segment_end_trapezoid_index(trapezoid_data, root, line_index, true, false);
+        uint32_t const end_trapezoid = get_line_segment_end_trapezoid_index(trapezoid_data, root, line_index, false, false);
+
+        if (begin_trapezoid == end_trapezoid)
         {
-            trapezoid_data.ends_of_line_segment[i] = dcel.vertices[i].coordinate;
+            call_handler(trapezoid_data, TrapezoidBuildStatistics::Handler::InsideOneTrapezoid, [&]() noexcept(!IS_DEBUG)
+                {
+                    handle_inside_one_trapezoid(trapezoid_data, begin_trapezoid, begin_index, end_index, line_index);
+                });
         }
-
-        std::vector<LineSegment> double_edges(dcel.edges.size());
-
-        for (size_t i = 0; i < double_edges.size(); ++i)
+        if (begin_trapezoid != end_trapezoid)
         {
-            size_t first_vertex = dcel.edges[i].origin_vertex;
-            size_t second_vertex = dcel.edges[dcel.edges[i].twin_edge].origin_vertex;
+            handle_between_trapezoids(trapezoid_data, begin_trapezoid, end_trapezoid, begin_index, end_index, line_index);
+        }
+    }
+}
 
-            frm::Point const begin = dcel.vertices[first_vertex].coordinate;
-            frm::Point const end = dcel.vertices[second_vertex].coordinate;
+// trapezoids and graph are built again from line segments which are not removed
+// removed line segments become free, outside rectangle is placed around all ends
+void build_trapezoid_graph(TrapezoidData & trapezoid_data, uint32_t & root, uint32_t outside_face_index, size_t seed) noexcept(!IS_DEBUG)
+{
+    trapezoid_data.trapezoids.clear();
+    trapezoid_data.graph_nodes.clear();
+    trapezoid_data.free_trapezoids.clear();
+
+    trapezoid_data.free_line_segments.insert(
+        trapezoid_data.free_line_segments.end(),
+        trapezoid_data.removed_line_segments.begin(),
+        trapezoid_data.removed_line_segments.end()
+    );
+    trapezoid_data.removed_line_segments.clear();
 
-            size_t face_over_line;
-            size_t face_under_line;
+    std::vector<bool> is_line_segment_inserted(trapezoid_data.line_segments.size(), true);
+    for (uint32_t free_line_segment : trapezoid_data.free_line_segments)
+    {
+        is_line_segment_inserted[free_line_segment] = false;
+    }
 
-            if (end.x - begin.x < frm::epsilon)
-            {
-                face_under_line = dcel.edges[i].incident_face;
-                face_over_line = dcel.edges[dcel.edges[i].twin_edge].incident_face;
-            }
-            else
-            {
-                face_over_line = dcel.edges[i].incident_face;
-                face_under_line = dcel.edges[dcel.edges[i].twin_edge].incident_face;
-            }
+    bool const is_outside_rectangle_created = trapezoid_data.top_line_segment_index != null_trapezoid_data_index;
 
-            if (second_vertex > first_vertex)
-            {
-                std::swap(first_vertex, second_vertex);
-            }
+    std::vector<uint32_t> insertion_order{};
+    insertion_order.reserve(trapezoid_data.line_segments.size());
 
-            double_edges[i] = { first_vertex, second_vertex, face_over_line, face_under_line };
+    for (uint32_t i = 0; i < trapezoid_data.line_segments.size(); ++i)
+    {
+        if (is_line_segment_inserted[i] && i != trapezoid_data.top_line_segment_index && i != trapezoid_data.bottom_line_segment_index)
+        {
+            insertion_order.push_back(i);
         }
+    }
 
-        std::sort(double_edges.begin(), double_edges.end(), [&dcel](LineSegment a, LineSegment b) noexcept -> bool
-            {
-                if (a.begin_index == b.begin_index)
-                {
-                    return a.end_index < b.end_index;
-                }
-                return a.begin_index < b.begin_index;
-            });
+    std::shuffle(
+        insertion_order.begin(),
+        insertion_order.end(),
+        std::default_random_engine{ static_cast<std::default_random_engine::result_type>(seed) }
+    );
 
-        trapezoid_data.line_segments.resize(double_edges.size() / 2);
+    // init outside rectangle
+    {
+        uint32_t const ends_count = is_outside_rectangle_created ?
+            trapezoid_data.line_segments[trapezoid_data.top_line_segment_index].begin_index :
+            static_cast<uint32_t>(trapezoid_data.ends_of_line_segment.size());
 
-        for (size_t i = 0; i < double_edges.size(); i += 2)
-        {
-            trapezoid_data.line_segments[i / 2] = double_edges[i];
-        }
+        float top = trapezoid_data.ends_of_line_segment[0].y;
+        float bottom = trapezoid_data.ends_of_line_segment[0].y;
+        float right = trapezoid_data.ends_of_line_segment[0].x;
+        float left = trapezoid_data.ends_of_line_segment[0].x;
 
-        for (size_t i = 0; i < trapezoid_data.line_segments.size(); ++i)
+        for (size_t i = 0; i < trapezoid_data.ends_of_line_segment.size(); ++i)
         {
-            size_t const begin_index = trapezoid_data.line_segments[i].begin_index;
-            size_t const end_index = trapezoid_data.line_segments[i].end_index;
-            frm::Point const begin = trapezoid_data.ends_of_line_segment[begin_index];
-            frm::Point const end = trapezoid_data.ends_of_line_segment[end_index];
-
-            if (begin.x - end.x > frm::epsilon)
+            // corners of outside rectangle are placed after ends of dcel
+            if (is_outside_rectangle_created && i >= ends_count && i < ends_count + 4)
             {
-                trapezoid_data.line_segments[i] = {
-                    end_index,
-                    begin_index,
-                    trapezoid_data.line_segments[i].face_over_line,
-                    trapezoid_data.line_segments[i].face_under_line
-                };
+                continue;
             }
+
+            top = std::max(top, trapezoid_data.ends_of_line_segment[i].y);
+            bottom = std::min(bottom, trapezoid_data.ends_of_line_segment[i].y);
+            right = std::max(right, trapezoid_data.ends_of_line_segment[i].x);
+            left = std::min(left, trapezoid_data.ends_of_line_segment[i].x);
         }
 
-        std::shuffle(trapezoid_data.line_segments.begin(), trapezoid_data.line_segments.end(), std::default_random_engine{});
-    }
+        float const offset_to_side = 100.f * frm::epsilon;
 
-    // init outside rectangle
-    {
-        float top = dcel.vertices[0].coordinate.y;
-        float bottom = dcel.vertices[0].coordinate.y;
-        float right = dcel.vertices[0].coordinate.x;
-        float left = dcel.vertices[0].coordinate.x;
+        frm::Point const corners[] = {
+            { left - offset_to_side, top + offset_to_side },
+            { right + offset_to_side, top + offset_to_side },
+            { left - offset_to_side, bottom - offset_to_side },
+            { right + offset_to_side, bottom - offset_to_side }
+        };
 
-        for (size_t i = 0; i < dcel.vertices.size(); ++i)
+        if (!is_outside_rectangle_created)
         {
-            top = std::max(top, dcel.vertices[i].coordinate.y);
-            bottom = std::min(bottom, dcel.vertices[i].coordinate.y);
-            right = std::max(right, dcel.vertices[i].coordinate.x);
-            left = std::min(left, dcel.vertices[i].coordinate.x);
-        }
+            trapezoid_data.ends_of_line_segment.insert(trapezoid_data.ends_of_line_segment.end(), std::begin(corners), std::end(corners));
 
-        float const offset_to_side = 100.f * frm::epsilon;
+            trapezoid_data.top_line_segment_index = static_cast<uint32_t>(trapezoid_data.line_segments.size());
+            trapezoid_data.line_segments.emplace_back(LineSegment{ ends_count, ends_count + 1, outside_face_index, outside_face_index });
+            trapezoid_data.bottom_line_segment_index = static_cast<uint32_t>(trapezoid_data.line_segments.size());
+            trapezoid_data.line_segments.emplace_back(LineSegment{ ends_count + 2, ends_count + 3, outside_face_index, outside_face_index });
+        }
+        else
+        {
+            std::copy(std::begin(corners), std::end(corners), trapezoid_data.ends_of_line_segment.begin() + ends_count);
+        }
 
-        size_t const left_top_end = trapezoid_data.ends_of_line_segment.size();
-        trapezoid_data.ends_of_line_segment.emplace_back(frm::Point{ left - offset_to_side, top + offset_to_side });
-        size_t const right_top_end = trapezoid_data.ends_of_line_segment.size();
-        trapezoid_data.ends_of_line_segment.emplace_back(frm::Point{ right + offset_to_side, top + offset_to_side });
-        size_t const left_bottom_end = trapezoid_data.ends_of_line_segment.size();
-        trapezoid_data.ends_of_line_segment.emplace_back(frm::Point{ left - offset_to_side, bottom - offset_to_side });
-        size_t const right_bottom_end = trapezoid_data.ends_of_line_segment.size();
-        trapezoid_data.ends_of_line_segment.emplace_back(frm::Point{ right + offset_to_side, bottom - offset_to_side });
-
-        size_t const top_line_segment_index = trapezoid_data.line_segments.size();
-        trapezoid_data.line_segments.emplace_back(LineSegment{ left_top_end, right_top_end, outside_face_index, outside_face_index });
-        size_t const bottom_line_segment_index = trapezoid_data.line_segments.size();
-        trapezoid_data.line_segments.emplace_back(LineSegment{ left_bottom_end, right_bottom_end, outside_face_index, outside_face_index });
-
-        size_t const outside_rectangle_index = trapezoid_data.trapezoids.size();
-        trapezoid_data.trapezoids.push_back({});
+        uint32_t const outside_rectangle_index = get_free_trapezoid_index(trapezoid_data);
         Trapezoid & outside_rectangle = trapezoid_data.trapezoids[outside_rectangle_index];
 
-        outside_rectangle.top_line_segment_index = top_line_segment_index;
-        outside_rectangle.bottom_line_segment_index = bottom_line_segment_index;
+        outside_rectangle.top_line_segment_index = trapezoid_data.top_line_segment_index;
+        outside_rectangle.bottom_line_segment_index = trapezoid_data.bottom_line_segment_index;
 
-        outside_rectangle.left_end_index = left_top_end;
-        outside_rectangle.right_end_index = right_top_end;
+        outside_rectangle.left_end_index = ends_count;
+        outside_rectangle.right_end_index = ends_count + 1;
 
-        root = std::make_shared<GraphNode>();
-        root->type = GraphNode::Type::Leaf;
-        root->index_by_type = outside_rectangle_index;
+        root = get_free_graph_node_index(trapezoid_data);
+        trapezoid_data.graph_nodes[root].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[root].index_by_type = outside_rectangle_index;
         outside_rectangle.trapezoid_node = root;
     }
 
-    for (size_t i = 0; i < trapezoid_data.line_segments.size() - 2; ++i)
+    for (LineSegment & line_segment : trapezoid_data.line_segments)
     {
-        size_t const begin_index = trapezoid_data.line_segments[i].begin_index;
-        size_t const end_index = trapezoid_data.line_segments[i].end_index;
-
-        frm::Point const begin = trapezoid_data.ends_of_line_segment[begin_index];
-        frm::Point const end = trapezoid_data.ends_of_line_segment[end_index];
-
-        if (abs(begin.x - end.x) > frm::epsilon)
-        {
-            frm::Point const begin_offseted = frm::lerp(begin, end, frm::epsilon * 10.f);
-            frm::Point const end_offseted = frm::lerp(end, begin, frm::epsilon * 10.f);
+        update_line_segment_coefficients(trapezoid_data, line_segment);
+    }
 
-            std::shared_ptr<GraphNode> begin_trapezoid = get_trapezoid_index(trapezoid_data, root, begin_offseted);
-            std::shared_ptr<GraphNode> end_trapezoid = get_trapezoid_index(trapezoid_data, root, end_offseted);
+    auto const insertion_begin = std::chrono::steady_clock::now();
 
-            if (begin_trapezoid == end_trapezoid)
-            {
-                handle_inside_one_trapezoid(trapezoid_data, begin_trapezoid, begin_index, end_index, i);
-            }
-            if (begin_trapezoid != end_trapezoid)
-            {
-                handle_between_trapezoids(trapezoid_data, begin_trapezoid, end_trapezoid, begin_index, end_index, i);
-            }
-        }
+    for (uint32_t line_index : insertion_order)
+    {
+        insert_line_segment_in_graph(trapezoid_data, root, line_index);
     }
 
-    trapezoid_data_and_graph_root_t trapezoid_data_and_graph_root{};
-    trapezoid_data_and_graph_root.first = outside_face_index;
-    trapezoid_data_and_graph_root.second.first = std::move(trapezoid_data);
-    trapezoid_data_and_graph_root.second.second = root;
+    if (trapezoid_data.build_statistics != nullptr)
+    {
+        auto const insertion_end = std::chrono::steady_clock::now();
 
-    return trapezoid_data_and_graph_root;
+        trapezoid_data.build_statistics->inserted_line_segments += insertion_order.size();
+        trapezoid_data.build_statistics->insertion_time += std::chrono::duration_cast<std::chrono::nanoseconds>(insertion_end - insertion_begin);
+    }
 }
 
-size_t get_face_index(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG)
+// trapezoids over or under line segment from its begin to its end
+// returns false if neighbors of trapezoids do not follow line segment
+bool get_trapezoids_next_to_line_segment(
+    TrapezoidData const & trapezoid_data,
+    uint32_t root,
+    uint32_t line_index,
+    bool is_over,
+    std::vector<uint32_t> & trapezoids
+) noexcept(!IS_DEBUG)
 {
-    std::shared_ptr<GraphNode> trapezoid_node = get_trapezoid_index(trapezoid_data_and_graph_root.second.first, trapezoid_data_and_graph_root.second.second, point);
+    LineSegment const & line_segment = trapezoid_data.line_segments[line_index];
 
-    size_t const trapezoid_index = trapezoid_node->index_by_type;
-    Trapezoid const trapezoid = trapezoid_data_and_graph_root.second.first.trapezoids[trapezoid_index];
+    auto const get_side_line_index = [&trapezoid_data, is_over](uint32_t trapezoid_index) noexcept -> uint32_t
+    {
+        Trapezoid const & trapezoid = trapezoid_data.trapezoids[trapezoid_index];
+        return is_over ? trapezoid.bottom_line_segment_index : trapezoid.top_line_segment_index;
+    };
 
-    LineSegment top_line_segment = trapezoid_data_and_graph_root.second.first.line_segments[trapezoid.top_line_segment_index];
-    LineSegment bottom_line_segment = trapezoid_data_and_graph_root.second.first.line_segments[trapezoid.bottom_line_segment_index];
+    uint32_t const begin_node = get_line_segment_end_trapezoid_index(trapezoid_data, root, line_index, true, is_over);
+    uint32_t current = trapezoid_data.graph_nodes[begin_node].index_by_type;
 
-    assert(top_line_segment.face_under_line == bottom_line_segment.face_over_line);
+    // walls of ends with equal x are ordered by insertion, so trapezoids of zero width next to line segment
+    // may be on both sides of found one and on both sides of walls of its begin and end
+    for (size_t i = 0; ; ++i)
+    {
+        Trapezoid const & trapezoid = trapezoid_data.trapezoids[current];
+        uint32_t const left_index = is_over ? trapezoid.bottom_left_neighbor_index : trapezoid.top_left_neighbor_index;
+
+        if (left_index == null_trapezoid_data_index || get_side_line_index(left_index) != line_index)
+        {
+            break;
+        }
+        if (i == trapezoid_data.trapezoids.size())
+        {
+            return false;
+        }
+
+        current = left_index;
+    }
+
+    if (get_side_line_index(current) != line_index ||
+        abs(trapezoid_data.ends_of_line_segment[trapezoid_data.trapezoids[current].left_end_index].x -
+            trapezoid_data.ends_of_line_segment[line_segment.begin_index].x) > frm::epsilon)
+    {
+        return false;
+    }
+
+    while (trapezoids.size() < trapezoid_data.trapezoids.size())
+    {
+        Trapezoid const & trapezoid = trapezoid_data.trapezoids[current];
+
+        trapezoids.push_back(current);
+
+        uint32_t const right_index = is_over ? trapezoid.bottom_right_neighbor_index : trapezoid.top_right_neighbor_index;
+
+        if (right_index == null_trapezoid_data_index || get_side_line_index(right_index) != line_index)
+        {
+            return abs(trapezoid_data.ends_of_line_segment[trapezoid.right_end_index].x -
+                trapezoid_data.ends_of_line_segment[line_segment.end_index].x) <= frm::epsilon;
+        }
+        if (trapezoid_data.trapezoids[right_index].left_end_index != trapezoid.right_end_index)
+        {
+            return false;
+        }
+
+        current = right_index;
+    }
+
+    return false;
+}
+
+// node becomes root of x-nodes over trapezoid nodes [first, last), walls are left ends of trapezoids
+void make_x_nodes(
+    TrapezoidData & trapezoid_data,
+    uint32_t node,
+    std::vector<uint32_t> const & trapezoid_nodes,
+    std::vector<uint32_t> const & walls,
+    size_t first,
+    size_t last
+) noexcept
+{
+    // the only trapezoid is reached by both children
+    if (last - first == 1)
+    {
+        trapezoid_data.graph_nodes[node].type = GraphNode::Type::XUnit;
+        trapezoid_data.graph_nodes[node].index_by_type = walls[first];
+        trapezoid_data.graph_nodes[node].left_child = trapezoid_nodes[first];
+        trapezoid_data.graph_nodes[node].right_child = trapezoid_nodes[first];
+        return;
+    }
+
+    size_t const middle = (first + last) / 2;
+
+    auto const get_child = [&](size_t child_first, size_t child_last) noexcept -> uint32_t
+    {
+        if (child_last - child_first == 1)
+        {
+            return trapezoid_nodes[child_first];
+        }
+
+        uint32_t const child = get_free_graph_node_index(trapezoid_data);
+        make_x_nodes(trapezoid_data, child, trapezoid_nodes, walls, child_first, child_last);
+        return child;
+    };
+
+    uint32_t const left_child = get_child(first, middle);
+    uint32_t const right_child = get_child(middle, last);
+
+    trapezoid_data.graph_nodes[node].type = GraphNode::Type::XUnit;
+    trapezoid_data.graph_nodes[node].index_by_type = walls[middle];
+    trapezoid_data.graph_nodes[node].left_child = left_child;
+    trapezoid_data.graph_nodes[node].right_child = right_child;
+}
+
+// trapezoids over and under line segment are merged, walls of ends between them go through line segment
+// free end of line segment loses its wall, merged trapezoid is joined with trapezoid behind the wall
+// leaves of old trapezoids become x-nodes over merged trapezoids, y-nodes of line segment stay in graph
+// returns false and changes nothing if trapezoids next to line segment are not found
+bool remove_line_segment_from_graph(TrapezoidData & trapezoid_data, uint32_t root, uint32_t line_index) noexcept(!IS_DEBUG)
+{
+    std::vector<uint32_t> top_indices{};
+    std::vector<uint32_t> bottom_indices{};
+
+    if (!get_trapezoids_next_to_line_segment(trapezoid_data, root, line_index, true, top_indices) ||
+        !get_trapezoids_next_to_line_segment(trapezoid_data, root, line_index, false, bottom_indices))
+    {
+        return false;
+    }
+
+    // trapezoids of zero width may be only on one side, but both sides begin and end in the same walls
+    if (trapezoid_data.trapezoids[top_indices.front()].left_end_index != trapezoid_data.trapezoids[bottom_indices.front()].left_end_index ||
+        trapezoid_data.trapezoids[top_indices.back()].right_end_index != trapezoid_data.trapezoids[bottom_indices.back()].right_end_index)
+    {
+        return false;
+    }
+
+    // records are reused by merged trapezoids
+    std::vector<Trapezoid> top_trapezoids(top_indices.size());
+    std::vector<Trapezoid> bottom_trapezoids(bottom_indices.size());
+
+    for (size_t i = 0; i < top_indices.size(); ++i)
+    {
+        top_trapezoids[i] = trapezoid_data.trapezoids[top_indices[i]];
+    }
+    for (size_t i = 0; i < bottom_indices.size(); ++i)
+    {
+        bottom_trapezoids[i] = trapezoid_data.trapezoids[bottom_indices[i]];
+    }
+
+    // merged trapezoid t is under top trapezoid tops[t] and over bottom trapezoid bottoms[t]
+    // walls[t] is its left end, walls of top and bottom trapezoids are merged by x
+    std::vector<size_t> tops{ 0 };
+    std::vector<size_t> bottoms{ 0 };
+    std::vector<bool> is_top_walls{ false };
+    std::vector<uint32_t> walls{ top_trapezoids.front().left_end_index };
+
+    while (tops.back() + 1 < top_trapezoids.size() || bottoms.back() + 1 < bottom_trapezoids.size())
+    {
+        size_t const top = tops.back();
+        size_t const bottom = bottoms.back();
+
+        bool const is_top_wall = bottom + 1 == bottom_trapezoids.size() || (top + 1 < top_trapezoids.size() &&
+            trapezoid_data.ends_of_line_segment[top_trapezoids[top].right_end_index].x <=
+            trapezoid_data.ends_of_line_segment[bottom_trapezoids[bottom].right_end_index].x);
+
+        tops.push_back(is_top_wall ? top + 1 : top);
+        bottoms.push_back(is_top_wall ? bottom : bottom + 1);
+        is_top_walls.push_back(is_top_wall);
+        walls.push_back(is_top_wall ? top_trapezoids[top].right_end_index : bottom_trapezoids[bottom].right_end_index);
+    }
+
+    size_t const merged_count = walls.size();
+
+    // end without other line segments has one trapezoid on its other side which covers its wall
+    auto const get_joined_trapezoid_index = [&](uint32_t top_neighbor_index, uint32_t bottom_neighbor_index, size_t merged) noexcept -> uint32_t
+    {
+        if (top_neighbor_index == null_trapezoid_data_index || top_neighbor_index != bottom_neighbor_index)
+        {
+            return null_trapezoid_data_index;
+        }
+
+        Trapezoid const & neighbor = trapezoid_data.trapezoids[top_neighbor_index];
+
+        if (neighbor.top_line_segment_index != top_trapezoids[tops[merged]].top_line_segment_index ||
+            neighbor.bottom_line_segment_index != bottom_trapezoids[bottoms[merged]].bottom_line_segment_index)
+        {
+            return null_trapezoid_data_index;
+        }
+        return top_neighbor_index;
+    };
+
+    uint32_t const left_index = get_joined_trapezoid_index(top_trapezoids.front().top_left_neighbor_index, bottom_trapezoids.front().bottom_left_neighbor_index, 0);
+    uint32_t right_index = get_joined_trapezoid_index(top_trapezoids.back().top_right_neighbor_index, bottom_trapezoids.back().bottom_right_neighbor_index, merged_count - 1);
+
+    if (right_index == left_index)
+    {
+        right_index = null_trapezoid_data_index;
+    }
+
+    std::vector<uint32_t> free_indices(top_indices);
+    free_indices.insert(free_indices.end(), bottom_indices.begin(), bottom_indices.end());
+
+    std::vector<uint32_t> indices(merged_count);
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        if (t == 0 && left_index != null_trapezoid_data_index)
+        {
+            indices[t] = left_index;
+        }
+        else if (t + 1 == merged_count && right_index != null_trapezoid_data_index)
+        {
+            indices[t] = right_index;
+        }
+        else
+        {
+            indices[t] = free_indices.back();
+            free_indices.pop_back();
+        }
+    }
+
+    // the only merged trapezoid joins both trapezoids, the right one is removed
+    bool const is_right_joined_to_left = merged_count == 1 && left_index != null_trapezoid_data_index && right_index != null_trapezoid_data_index;
+    Trapezoid const right_trapezoid = right_index == null_trapezoid_data_index ? Trapezoid{} : trapezoid_data.trapezoids[right_index];
+
+    if (is_right_joined_to_left)
+    {
+        free_indices.push_back(right_index);
+    }
+
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        Trapezoid const & top_trapezoid = top_trapezoids[tops[t]];
+        Trapezoid const & bottom_trapezoid = bottom_trapezoids[bottoms[t]];
+
+        Trapezoid merged{};
+        merged.top_line_segment_index = top_trapezoid.top_line_segment_index;
+        merged.bottom_line_segment_index = bottom_trapezoid.bottom_line_segment_index;
+        merged.left_end_index = walls[t];
+        merged.right_end_index = t + 1 == merged_count ? top_trapezoids.back().right_end_index : walls[t + 1];
+
+        if (t == 0)
+        {
+            merged.top_left_neighbor_index = top_trapezoid.top_left_neighbor_index;
+            merged.bottom_left_neighbor_index = bottom_trapezoid.bottom_left_neighbor_index;
+        }
+        else
+        {
+            merged.top_left_neighbor_index = is_top_walls[t] ? top_trapezoid.top_left_neighbor_index : indices[t - 1];
+            merged.bottom_left_neighbor_index = is_top_walls[t] ? indices[t - 1] : bottom_trapezoid.bottom_left_neighbor_index;
+        }
+
+        if (t + 1 == merged_count)
+        {
+            merged.top_right_neighbor_index = top_trapezoid.top_right_neighbor_index;
+            merged.bottom_right_neighbor_index = bottom_trapezoid.bottom_right_neighbor_index;
+        }
+        else
+        {
+            merged.top_right_neighbor_index = is_top_walls[t + 1] ? top_trapezoid.top_right_neighbor_index : indices[t + 1];
+            merged.bottom_right_neighbor_index = is_top_walls[t + 1] ? indices[t + 1] : bottom_trapezoid.bottom_right_neighbor_index;
+        }
+
+        Trapezoid & trapezoid = trapezoid_data.trapezoids[indices[t]];
+
+        if (t == 0 && left_index != null_trapezoid_data_index)
+        {
+            Trapezoid const & right_side = is_right_joined_to_left ? right_trapezoid : merged;
+
+            trapezoid.right_end_index = right_side.right_end_index;
+            trapezoid.top_right_neighbor_index = right_side.top_right_neighbor_index;
+            trapezoid.bottom_right_neighbor_index = right_side.bottom_right_neighbor_index;
+        }
+        else if (t + 1 == merged_count && right_index != null_trapezoid_data_index)
+        {
+            trapezoid.left_end_index = merged.left_end_index;
+            trapezoid.top_left_neighbor_index = merged.top_left_neighbor_index;
+            trapezoid.bottom_left_neighbor_index = merged.bottom_left_neighbor_index;
+        }
+        else
+        {
+            trapezoid = merged;
+        }
+    }
+
+    for (uint32_t free_index : free_indices)
+    {
+        trapezoid_data.trapezoids[free_index] = {};
+        trapezoid_data.free_trapezoids.push_back(free_index);
+    }
+
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        update_famous_neighbors(trapezoid_data, indices[t]);
+    }
+
+    // leaf of trapezoid which covers one merged trapezoid is reused by it, other leaves become x-nodes
+    std::vector<uint32_t> trapezoid_nodes(merged_count, null_graph_node_index);
+
+    if (left_index != null_trapezoid_data_index)
+    {
+        trapezoid_nodes.front() = trapezoid_data.trapezoids[left_index].trapezoid_node;
+    }
+    if (right_index != null_trapezoid_data_index && !is_right_joined_to_left)
+    {
+        trapezoid_nodes.back() = right_trapezoid.trapezoid_node;
+    }
+
+    // merged trapezoids [first, last) are covered by old trapezoid
+    struct CoveringTrapezoid
+    {
+        uint32_t node;
+        size_t first;
+        size_t last;
+    };
+
+    std::vector<CoveringTrapezoid> covering_trapezoids{};
+
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        if (t == 0 || tops[t] != tops[t - 1])
+        {
+            covering_trapezoids.push_back({ top_trapezoids[tops[t]].trapezoid_node, t, t + 1 });
+        }
+        else
+        {
+            covering_trapezoids.back().last = t + 1;
+        }
+    }
+
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        if (t == 0 || bottoms[t] != bottoms[t - 1])
+        {
+            covering_trapezoids.push_back({ bottom_trapezoids[bottoms[t]].trapezoid_node, t, t + 1 });
+        }
+        else
+        {
+            covering_trapezoids.back().last = t + 1;
+        }
+    }
+
+    std::vector<bool> is_node_reused(covering_trapezoids.size(), false);
+
+    for (size_t i = 0; i < covering_trapezoids.size(); ++i)
+    {
+        CoveringTrapezoid const & covering_trapezoid = covering_trapezoids[i];
+
+        if (covering_trapezoid.last - covering_trapezoid.first == 1 && trapezoid_nodes[covering_trapezoid.first] == null_graph_node_index)
+        {
+            trapezoid_nodes[covering_trapezoid.first] = covering_trapezoid.node;
+            is_node_reused[i] = true;
+        }
+    }
+
+    for (size_t t = 0; t < merged_count; ++t)
+    {
+        if (trapezoid_nodes[t] == null_graph_node_index)
+        {
+            trapezoid_nodes[t] = get_free_graph_node_index(trapezoid_data);
+        }
+
+        trapezoid_data.graph_nodes[trapezoid_nodes[t]].type = GraphNode::Type::Leaf;
+        trapezoid_data.graph_nodes[trapezoid_nodes[t]].index_by_type = indices[t];
+        trapezoid_data.graph_nodes[trapezoid_nodes[t]].left_child = null_graph_node_index;
+        trapezoid_data.graph_nodes[trapezoid_nodes[t]].right_child = null_graph_node_index;
+        trapezoid_data.trapezoids[indices[t]].trapezoid_node = trapezoid_nodes[t];
+    }
+
+    for (size_t i = 0; i < covering_trapezoids.size(); ++i)
+    {
+        if (!is_node_reused[i])
+        {
+            make_x_nodes(trapezoid_data, covering_trapezoids[i].node, trapezoid_nodes, walls, covering_trapezoids[i].first, covering_trapezoids[i].last);
+        }
+    }
+
+    if (is_right_joined_to_left)
+    {
+        make_x_nodes(trapezoid_data, right_trapezoid.trapezoid_node, trapezoid_nodes, walls, 0, 1);
+    }
+
+    return true;
+}
+
+trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG)
+{
+    return generate_trapezoid_data_and_graph_root_with_seed(dcel, std::default_random_engine::default_seed);
+}
+
+trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root_with_seed(
+    frm::dcel::DCEL const & dcel,
+    size_t seed,
+    TrapezoidBuildStatistics * build_statistics
+) noexcept(!IS_DEBUG)
+{
+    TrapezoidData trapezoid_data{};
+    trapezoid_data.build_statistics = build_statistics;
+    trapezoid_data.seed = seed;
+    uint32_t root = null_graph_node_index;
+
+    assert(dcel.vertices.size() + 4 < null_trapezoid_data_index && dcel.edges.size() / 2 + 2 < null_trapezoid_data_index);
+    assert(dcel.faces.size() < null_trapezoid_data_index);
+
+    uint32_t const outside_face_index = static_cast<uint32_t>(frm::dcel::get_outside_face_index(dcel));
+
+    // convert dcel to trapezoid data
+    {
+        trapezoid_data.ends_of_line_segment.resize(dcel.vertices.size());
+        for (size_t i = 0; i < dcel.vertices.size(); ++i)
+        {
+            trapezoid_data.ends_of_line_segment[i] = dcel.vertices[i].coordinate;
+        }
+
+        std::vector<LineSegment> double_edges(dcel.edges.size());
+
+        for (size_t i = 0; i < double_edges.size(); ++i)
+        {
+            uint32_t first_vertex = static_cast<uint32_t>(dcel.edges[i].origin_vertex);
+            uint32_t second_vertex = static_cast<uint32_t>(dcel.edges[dcel.edges[i].twin_edge].origin_vertex);
+
+            frm::Point const begin = dcel.vertices[first_vertex].coordinate;
+            frm::Point const end = dcel.vertices[second_vertex].coordinate;
+
+            uint32_t face_over_line;
+            uint32_t face_under_line;
+
+            if (end.x - begin.x < frm::epsilon)
+            {
+                face_under_line = static_cast<uint32_t>(dcel.edges[i].incident_face);
+                face_over_line = static_cast<uint32_t>(dcel.edges[dcel.edges[i].twin_edge].incident_face);
+            }
+            else
+            {
+                face_over_line = static_cast<uint32_t>(dcel.edges[i].incident_face);
+                face_under_line = static_cast<uint32_t>(dcel.edges[dcel.edges[i].twin_edge].incident_face);
+            }
+
+            if (second_vertex > first_vertex)
+            {
+                std::swap(first_vertex, second_vertex);
+            }
+
+            double_edges[i] = { first_vertex, second_vertex, face_over_line, face_under_line };
+        }
+
+        std::sort(double_edges.begin(), double_edges.end(), [&dcel](LineSegment a, LineSegment b) noexcept -> bool
+            {
+                if (a.begin_index == b.begin_index)
+                {
+                    return a.end_index < b.end_index;
+                }
+                return a.begin_index < b.begin_index;
+            });
+
+        trapezoid_data.line_segments.resize(double_edges.size() / 2);
+
+        for (size_t i = 0; i < double_edges.size(); i += 2)
+        {
+            trapezoid_data.line_segments[i / 2] = double_edges[i];
+        }
+
+        for (size_t i = 0; i < trapezoid_data.line_segments.size(); ++i)
+        {
+            uint32_t const begin_index = trapezoid_data.line_segments[i].begin_index;
+            uint32_t const end_index = trapezoid_data.line_segments[i].end_index;
+            frm::Point const begin = trapezoid_data.ends_of_line_segment[begin_index];
+            frm::Point const end = trapezoid_data.ends_of_line_segment[end_index];
+
+            if (begin.x - end.x > frm::epsilon)
+            {
+                trapezoid_data.line_segments[i] = {
+                    end_index,
+                    begin_index,
+                    trapezoid_data.line_segments[i].face_over_line,
+                    trapezoid_data.line_segments[i].face_under_line
+                };
+            }
+        }
+    }
+
+    build_trapezoid_graph(trapezoid_data, root, outside_face_index, seed);
+
+    // later insertions and rebuilds are not counted
+    trapezoid_data.build_statistics = nullptr;
+
+    trapezoid_data_and_graph_root_t trapezoid_data_and_graph_root{};
+    trapezoid_data_and_graph_root.first = outside_face_index;
+    trapezoid_data_and_graph_root.second.first = std::move(trapezoid_data);
+    trapezoid_data_and_graph_root.second.second = root;
+
+    return trapezoid_data_and_graph_root;
+}
+
+trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root_with_bounded_path_length(
+    frm::dcel::DCEL const & dcel,
+    size_t seed,
+    size_t retries_count,
+    float path_length_factor,
+    size_t threads_count
+) noexcept(!IS_DEBUG)
+{
+    retries_count = std::max(retries_count, size_t{ 1 });
+
+    size_t const line_segments_count = dcel.edges.size() / 2;
+    float const max_allowed_path_length = path_length_factor * std::log2(static_cast<float>(std::max(line_segments_count, size_t{ 2 })));
+
+    if (threads_count == 0)
+    {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads_count = std::min(threads_count, retries_count);
+
+    trapezoid_data_and_graph_root_t best_build{};
+    size_t best_path_length = std::numeric_limits<size_t>::max();
+
+    std::vector<trapezoid_data_and_graph_root_t> builds(threads_count);
+    std::vector<size_t> path_lengths(threads_count);
+
+    // every round builds next threads_count seeds, the first fitting seed wins as in serial order
+    for (size_t first_retry = 0; first_retry < retries_count; first_retry += threads_count)
+    {
+        size_t const round_size = std::min(threads_count, retries_count - first_retry);
+
+        auto const build = [&](size_t i) noexcept(!IS_DEBUG)
+        {
+            builds[i] = generate_trapezoid_data_and_graph_root_with_seed(dcel, seed + first_retry + i);
+            path_lengths[i] = get_max_graph_path_length(builds[i]);
+        };
+
+        std::vector<std::thread> threads{};
+
+        for (size_t i = 1; i < round_size; ++i)
+        {
+            threads.emplace_back(build, i);
+        }
+        build(0);
+
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+
+        for (size_t i = 0; i < round_size; ++i)
+        {
+            if (path_lengths[i] < best_path_length)
+            {
+                best_path_length = path_lengths[i];
+                best_build = std::move(builds[i]);
+            }
+
+            if (static_cast<float>(path_lengths[i]) <= max_allowed_path_length)
+            {
+                return best_build;
+            }
+        }
+    }
+
+    return best_build;
+}
+
+size_t get_max_graph_path_length(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG)
+{
+    std::vector<GraphNode> const & graph_nodes = trapezoid_data_and_graph_root.second.first.graph_nodes;
+
+    // nodes are shared, every node is visited once
+    std::vector<size_t> path_lengths(graph_nodes.size(), std::numeric_limits<size_t>::max());
+
+    // explicit stack, depth of graph is not bounded by O(log(n)) for unlucky order
+    std::vector<uint32_t> stack{ trapezoid_data_and_graph_root.second.second };
+
+    while (!stack.empty())
+    {
+        uint32_t const current = stack.back();
+        GraphNode const & node = graph_nodes[current];
+
+        if (node.type == GraphNode::Type::Leaf)
+        {
+            path_lengths[current] = 0;
+            stack.pop_back();
+            continue;
+        }
+
+        size_t const left_length = path_lengths[node.left_child];
+        size_t const right_length = path_lengths[node.right_child];
+
+        if (left_length == std::numeric_limits<size_t>::max())
+        {
+            stack.push_back(node.left_child);
+            continue;
+        }
+        if (right_length == std::numeric_limits<size_t>::max())
+        {
+            stack.push_back(node.right_child);
+            continue;
+        }
+
+        path_lengths[current] = std::max(left_length, right_length) + 1;
+        stack.pop_back();
+    }
+
+    return path_lengths[trapezoid_data_and_graph_root.second.second];
+}
+
+size_t add_end_of_line_segment(trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root, frm::Point point) noexcept
+{
+    std::vector<frm::Point> & ends_of_line_segment = trapezoid_data_and_graph_root.second.first.ends_of_line_segment;
+
+    assert(ends_of_line_segment.size() < null_trapezoid_data_index);
+
+    ends_of_line_segment.push_back(point);
+
+    return ends_of_line_segment.size() - 1;
+}
+
+size_t insert_line_segment(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t begin_index,
+    size_t end_index,
+    size_t face_over_line,
+    size_t face_under_line
+) noexcept(!IS_DEBUG)
+{
+    TrapezoidData & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+
+    if (trapezoid_data.ends_of_line_segment[begin_index].x - trapezoid_data.ends_of_line_segment[end_index].x > frm::epsilon)
+    {
+        std::swap(begin_index, end_index);
+    }
+
+    uint32_t line_index;
+
+    if (trapezoid_data.free_line_segments.empty())
+    {
+        assert(trapezoid_data.line_segments.size() < null_trapezoid_data_index);
+
+        line_index = static_cast<uint32_t>(trapezoid_data.line_segments.size());
+        trapezoid_data.line_segments.emplace_back();
+    }
+    else
+    {
+        line_index = trapezoid_data.free_line_segments.back();
+        trapezoid_data.free_line_segments.pop_back();
+    }
+
+    LineSegment & line_segment = trapezoid_data.line_segments[line_index];
+    line_segment = {
+        static_cast<uint32_t>(begin_index),
+        static_cast<uint32_t>(end_index),
+        static_cast<uint32_t>(face_over_line),
+        static_cast<uint32_t>(face_under_line)
+    };
+    update_line_segment_coefficients(trapezoid_data, line_segment);
+
+    frm::Point const top_left = trapezoid_data.ends_of_line_segment[trapezoid_data.line_segments[trapezoid_data.top_line_segment_index].begin_index];
+    frm::Point const bottom_right = trapezoid_data.ends_of_line_segment[trapezoid_data.line_segments[trapezoid_data.bottom_line_segment_index].end_index];
+
+    auto const is_inside_outside_rectangle = [top_left, bottom_right](frm::Point point) noexcept -> bool
+    {
+        return point.x > top_left.x && point.x < bottom_right.x && point.y < top_left.y && point.y > bottom_right.y;
+    };
+
+    // other line segments are inside outside rectangle, so it is changed only by rebuild
+    if (!is_inside_outside_rectangle(trapezoid_data.ends_of_line_segment[begin_index]) ||
+        !is_inside_outside_rectangle(trapezoid_data.ends_of_line_segment[end_index]))
+    {
+        build_trapezoid_graph(
+            trapezoid_data,
+            trapezoid_data_and_graph_root.second.second,
+            static_cast<uint32_t>(trapezoid_data_and_graph_root.first),
+            trapezoid_data.seed
+        );
+    }
+    else
+    {
+        insert_line_segment_in_graph(trapezoid_data, trapezoid_data_and_graph_root.second.second, line_index);
+    }
+
+    return line_index;
+}
+
+// records of free trapezoids have no node, other trapezoids are bounded by line segments which are not removed
+bool are_trapezoids_bounded_by_inserted_line_segments(TrapezoidData const & trapezoid_data) noexcept
+{
+    for (Trapezoid const & trapezoid : trapezoid_data.trapezoids)
+    {
+        if (trapezoid.trapezoid_node != null_graph_node_index &&
+            (trapezoid_data.line_segments[trapezoid.top_line_segment_index].is_removed ||
+                trapezoid_data.line_segments[trapezoid.bottom_line_segment_index].is_removed))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void remove_line_segment(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t line_segment_index
+) noexcept(!IS_DEBUG)
+{
+    TrapezoidData & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+    uint32_t const line_index = static_cast<uint32_t>(line_segment_index);
+
+    assert(line_index != trapezoid_data.top_line_segment_index && line_index != trapezoid_data.bottom_line_segment_index);
+    assert(!trapezoid_data.line_segments[line_index].is_removed);
+
+    LineSegment & line_segment = trapezoid_data.line_segments[line_index];
+    line_segment.is_removed = true;
+
+    frm::Point const begin = trapezoid_data.ends_of_line_segment[line_segment.begin_index];
+    frm::Point const end = trapezoid_data.ends_of_line_segment[line_segment.end_index];
+
+    // vertical line segments are not inserted in graph
+    if (abs(begin.x - end.x) <= frm::epsilon)
+    {
+        trapezoid_data.free_line_segments.push_back(line_index);
+        return;
+    }
+
+    trapezoid_data.removed_line_segments.push_back(line_index);
+
+    bool const is_removed_from_graph = remove_line_segment_from_graph(trapezoid_data, trapezoid_data_and_graph_root.second.second, line_index);
+
+    size_t const used_line_segments_count = trapezoid_data.line_segments.size() - trapezoid_data.free_line_segments.size();
+
+    // nodes of removed line segments are collected by rebuild
+    if (!is_removed_from_graph ||
+        2 * trapezoid_data.removed_line_segments.size() > used_line_segments_count - trapezoid_data.removed_line_segments.size())
+    {
+        build_trapezoid_graph(
+            trapezoid_data,
+            trapezoid_data_and_graph_root.second.second,
+            static_cast<uint32_t>(trapezoid_data_and_graph_root.first),
+            trapezoid_data.seed
+        );
+    }
+
+    assert(are_trapezoids_bounded_by_inserted_line_segments(trapezoid_data));
+}
+
+void set_line_segment_faces(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t line_segment_index,
+    size_t face_over_line,
+    size_t face_under_line
+) noexcept(!IS_DEBUG)
+{
+    LineSegment & line_segment = trapezoid_data_and_graph_root.second.first.line_segments[line_segment_index];
+
+    assert(!line_segment.is_removed);
+
+    line_segment.face_over_line = static_cast<uint32_t>(face_over_line);
+    line_segment.face_under_line = static_cast<uint32_t>(face_under_line);
+}
+
+void replace_face_index(trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root, size_t old_face_index, size_t new_face_index) noexcept
+{
+    uint32_t const old_face = static_cast<uint32_t>(old_face_index);
+    uint32_t const new_face = static_cast<uint32_t>(new_face_index);
+
+    for (LineSegment & line_segment : trapezoid_data_and_graph_root.second.first.line_segments)
+    {
+        if (line_segment.face_over_line == old_face)
+        {
+            line_segment.face_over_line = new_face;
+        }
+        if (line_segment.face_under_line == old_face)
+        {
+            line_segment.face_under_line = new_face;
+        }
+    }
+
+    if (trapezoid_data_and_graph_root.first == old_face_index)
+    {
+        trapezoid_data_and_graph_root.first = new_face_index;
+    }
+}
+
+size_t get_face_index(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG)
+{
+    uint32_t const trapezoid_node = get_trapezoid_index(trapezoid_data_and_graph_root.second.first, trapezoid_data_and_graph_root.second.second, point);
+
+    size_t const trapezoid_index = trapezoid_data_and_graph_root.second.first.graph_nodes[trapezoid_node].index_by_type;
+    Trapezoid const trapezoid = trapezoid_data_and_graph_root.second.first.trapezoids[trapezoid_index];
+
+    // removed line segments do not bound trapezoids, so top and bottom line segments give the same face
+    return trapezoid_data_and_graph_root.second.first.line_segments[trapezoid.top_line_segment_index].face_under_line;
+}
+
+// removed line segments do not bound trapezoids, so one descent is enough
+size_t get_line_segment_next_to_point(
+    trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root,
+    frm::Point point,
+    bool is_over
+) noexcept(!IS_DEBUG)
+{
+    TrapezoidData const & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+
+    uint32_t const trapezoid_node = get_trapezoid_index(trapezoid_data, trapezoid_data_and_graph_root.second.second, point);
+
+    Trapezoid const & trapezoid = trapezoid_data.trapezoids[trapezoid_data.graph_nodes[trapezoid_node].index_by_type];
+    uint32_t const line_index = is_over ? trapezoid.top_line_segment_index : trapezoid.bottom_line_segment_index;
+
+    if (line_index == trapezoid_data.top_line_segment_index || line_index == trapezoid_data.bottom_line_segment_index)
+    {
+        return null_trapezoid_data_index;
+    }
+    return line_index;
+}
+
+size_t get_line_segment_over_point(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG)
+{
+    return get_line_segment_next_to_point(trapezoid_data_and_graph_root, point, true);
+}
+
+size_t get_line_segment_under_point(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG)
+{
+    return get_line_segment_next_to_point(trapezoid_data_and_graph_root, point, false);
+}
+
+std::vector<size_t> get_trapezoids_crossed_by_line_segment(
+    trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root,
+    frm::Point begin,
+    frm::Point end
+) noexcept(!IS_DEBUG)
+{
+    TrapezoidData const & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+    uint32_t const root = trapezoid_data_and_graph_root.second.second;
+
+    std::vector<size_t> trapezoids{};
+
+    bool const is_vertical = abs(begin.x - end.x) <= frm::epsilon;
+
+    // walk goes from left to right, vertical line segment is walked from bottom to top
+    if (is_vertical ? begin.y > end.y : begin.x > end.x)
+    {
+        std::swap(begin, end);
+    }
+
+    float const k = is_vertical ? 0.f : (end.y - begin.y) / (end.x - begin.x);
+    float const c = end.y - k * end.x;
+
+    uint32_t trapezoid_node = is_vertical ?
+        get_trapezoid_index(trapezoid_data, root, begin) :
+        get_query_line_segment_begin_trapezoid_index(trapezoid_data, root, begin, end);
+
+    // line segment which was crossed last, walk continues on its other side and never crosses it back
+    uint32_t crossed_line_index = null_trapezoid_data_index;
+
+    // x of walk only grows, so every trapezoid is listed once
+    float walk_x = begin.x;
+
+    // query line segment goes from trapezoid over its top or under its bottom only if it turns to that side from line segment,
+    // its end is on that side and end of line segment is on the other side of it,
+    // signs are exact, so the same line segment is never crossed in both directions
+    auto const is_line_segment_crossed = [&](uint32_t line_index, bool is_over) noexcept -> bool
+    {
+        if (line_index == trapezoid_data.top_line_segment_index ||
+            line_index == trapezoid_data.bottom_line_segment_index ||
+            line_index == crossed_line_index)
+        {
+            return false;
+        }
+
+        LineSegment const & line_segment = trapezoid_data.line_segments[line_index];
+        frm::Point const line_begin = trapezoid_data.ends_of_line_segment[line_segment.begin_index];
+        frm::Point const line_end = trapezoid_data.ends_of_line_segment[line_segment.end_index];
+        int const side = is_over ? 1 : -1;
+
+        return get_cross_product_sign(line_begin, line_end, begin, end) == side &&
+            get_cross_product_sign(line_begin, line_end, end) == side &&
+            get_cross_product_sign(begin, end, line_end) == -side;
+    };
+
+    auto const get_crossing_x = [k, c](LineSegment const & line_segment) noexcept -> float
+    {
+        return (line_segment.c - c) / (k - line_segment.k);
+    };
+
+    // point closer than epsilon to end of line segment goes to the left of its wall in graph,
+    // so ends are compared by index there
+    auto const get_trapezoid_node_next_to_line_segment = [&trapezoid_data, root](uint32_t line_index, float x, bool is_over) noexcept(!IS_DEBUG) -> uint32_t
+    {
+        LineSegment const & line_segment = trapezoid_data.line_segments[line_index];
+
+        if (x - trapezoid_data.ends_of_line_segment[line_segment.begin_index].x <= frm::epsilon)
+        {
+            return get_line_segment_end_trapezoid_index(trapezoid_data, root, line_index, true, is_over);
+        }
+        if (trapezoid_data.ends_of_line_segment[line_segment.end_index].x - x <= frm::epsilon)
+        {
+            return get_line_segment_end_trapezoid_index(trapezoid_data, root, line_index, false, is_over);
+        }
+
+        frm::Point const point_on_line{ x, line_segment.k * x + line_segment.c };
+        return get_trapezoid_index_next_to_line_segment(trapezoid_data, root, point_on_line, line_index, is_over);
+    };
+
+    while (true)
+    {
+        assert(trapezoids.size() < trapezoid_data.trapezoids.size());
+
+        uint32_t const trapezoid_index = trapezoid_data.graph_nodes[trapezoid_node].index_by_type;
+        Trapezoid const & trapezoid = trapezoid_data.trapezoids[trapezoid_index];
+
+        trapezoids.push_back(trapezoid_index);
+
+        LineSegment const & top_line_segment = trapezoid_data.line_segments[trapezoid.top_line_segment_index];
+
+        if (is_vertical)
+        {
+            frm::Point const top_begin = trapezoid_data.ends_of_line_segment[top_line_segment.begin_index];
+            frm::Point const top_end = trapezoid_data.ends_of_line_segment[top_line_segment.end_index];
+
+            if (trapezoid.top_line_segment_index == trapezoid_data.top_line_segment_index ||
+                get_cross_product_sign(top_begin, top_end, end) <= 0)
+            {
+                break;
+            }
+
+            trapezoid_node = get_trapezoid_node_next_to_line_segment(trapezoid.top_line_segment_index, begin.x, true);
+            continue;
+        }
+
+        frm::Point const right_end = trapezoid_data.ends_of_line_segment[trapezoid.right_end_index];
+        bool const is_end_inside = end.x - right_end.x <= frm::epsilon;
+
+        bool const is_top_crossed = is_line_segment_crossed(trapezoid.top_line_segment_index, true);
+        bool const is_bottom_crossed = is_line_segment_crossed(trapezoid.bottom_line_segment_index, false);
+
+        if (is_top_crossed || is_bottom_crossed)
+        {
+            LineSegment const & bottom_line_segment = trapezoid_data.line_segments[trapezoid.bottom_line_segment_index];
+
+            // query line segment may cross both top and bottom, farther crossing is outside of trapezoid
+            bool const is_over = is_top_crossed &&
+                (!is_bottom_crossed || get_crossing_x(top_line_segment) < get_crossing_x(bottom_line_segment));
+
+            uint32_t const line_index = is_over ? trapezoid.top_line_segment_index : trapezoid.bottom_line_segment_index;
+            float const crossing_x = get_crossing_x(is_over ? top_line_segment : bottom_line_segment);
+
+            // crossing behind right wall is rounding error, walk goes to right neighbor then and crosses line segment there
+            if (is_end_inside || crossing_x < right_end.x)
+            {
+                walk_x = std::max(walk_x, crossing_x);
+                crossed_line_index = line_index;
+
+                trapezoid_node = get_trapezoid_node_next_to_line_segment(line_index, walk_x, is_over);
+                continue;
+            }
+        }
+
+        if (is_end_inside)
+        {
+            break;
+        }
+
+        walk_x = std::max(walk_x, right_end.x);
+
+        int const right_end_side = get_cross_product_sign(begin, end, right_end);
+
+        // line segments from end of wall may separate trapezoids next to it, so walk through it starts from it again
+        if (right_end_side == 0)
+        {
+            trapezoid_node = get_query_line_segment_begin_trapezoid_index(trapezoid_data, root, right_end, end);
+            continue;
+        }
+
+        // the same step as in handle_between_trapezoids
+        uint32_t const next_trapezoid_index = right_end_side > 0 ?
+            trapezoid.bottom_right_neighbor_index :
+            trapezoid.top_right_neighbor_index;
+
+        if (next_trapezoid_index == null_trapezoid_data_index)
+        {
+            break;
+        }
+
+        trapezoid_node = trapezoid_data.trapezoids[next_trapezoid_index].trapezoid_node;
+    }
 
-    return top_line_segment.face_under_line;
+    return trapezoids;
 }
\ No newline at end of file
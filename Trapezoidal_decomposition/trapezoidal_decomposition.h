@@ -3,7 +3,16 @@
 
 #include "dcel.h"
 
+#include <chrono>
 
+
+uint32_t constexpr null_graph_node_index = std::numeric_limits<uint32_t>::max();
+
+// indices of ends, line segments, faces and trapezoids are 32-bit to keep records small
+uint32_t constexpr null_trapezoid_data_index = std::numeric_limits<uint32_t>::max();
+
+
+// nodes are stored in TrapezoidData::graph_nodes, children are indices in it
 struct GraphNode
 {
     enum class Type : uint8_t
@@ -17,35 +26,70 @@ struct GraphNode
     };
 
     Type type;
-    size_t index_by_type;
+    uint32_t index_by_type;
 
-    std::shared_ptr<GraphNode> left_child{ nullptr };
-    std::shared_ptr<GraphNode> right_child{ nullptr };
+    uint32_t left_child{ null_graph_node_index };
+    uint32_t right_child{ null_graph_node_index };
 };
 
 struct LineSegment
 {
-    size_t begin_index;
-    size_t end_index;
-    size_t face_over_line;
-    size_t face_under_line;
+    uint32_t begin_index;
+    uint32_t end_index;
+    uint32_t face_over_line;
+    uint32_t face_under_line;
+
+    // y = k * x + c, precomputed for point location
+    float k{ 0.f };
+    float c{ 0.f };
+
+    // removed line segment is still compared by nodes of graph, its record is reused only after graph is rebuilt
+    bool is_removed{ false };
 };
 
 struct Trapezoid
 {
-    size_t top_line_segment_index{ std::numeric_limits<size_t>::max() };
-    size_t bottom_line_segment_index{ std::numeric_limits<size_t>::max() };
+    uint32_t top_line_segment_index{ null_trapezoid_data_index };
+    uint32_t bottom_line_segment_index{ null_trapezoid_data_index };
 
-    size_t left_end_index{ std::numeric_limits<size_t>::max() };
-    size_t right_end_index{ std::numeric_limits<size_t>::max() };
+    uint32_t left_end_index{ null_trapezoid_data_index };
+    uint32_t right_end_index{ null_trapezoid_data_index };
      
-    //*neighbor_index == std::numeric_limits<size_t>::max() => neighbor does not exist
-    size_t top_left_neighbor_index{ std::numeric_limits<size_t>::max() };
-    size_t bottom_left_neighbor_index{ std::numeric_limits<size_t>::max() };
-    size_t top_right_neighbor_index{ std::numeric_limits<size_t>::max() };
-    size_t bottom_right_neighbor_index{ std::numeric_limits<size_t>::max() };
+    //*neighbor_index == null_trapezoid_data_index => neighbor does not exist
+    uint32_t top_left_neighbor_index{ null_trapezoid_data_index };
+    uint32_t bottom_left_neighbor_index{ null_trapezoid_data_index };
+    uint32_t top_right_neighbor_index{ null_trapezoid_data_index };
+    uint32_t bottom_right_neighbor_index{ null_trapezoid_data_index };
+
+    uint32_t trapezoid_node{ null_graph_node_index };
+};
+
+// counters of graph construction, they are collected only if TrapezoidData::build_statistics is set
+struct TrapezoidBuildStatistics
+{
+    enum class Handler : uint8_t
+    {
+        InsideOneTrapezoid,
+        FirstTrapezoidWithExistingVertex,
+        FirstTrapezoidWithoutExistingVertex,
+        MiddleTrapezoid,
+        LastTrapezoidWithExistingVertex,
+        LastTrapezoidWithoutExistingVertex,
+        Count
+    };
+
+    static size_t constexpr handlers_count = static_cast<size_t>(Handler::Count);
+
+    // indices are Handler values
+    size_t handler_calls[handlers_count]{};
+    std::chrono::nanoseconds handler_times[handlers_count]{};
+
+    size_t inserted_line_segments{ 0 };
+    std::chrono::nanoseconds insertion_time{ 0 };
 
-    std::shared_ptr<GraphNode> trapezoid_node;
+    // every handler destroys one trapezoid, its record is reused by one of created trapezoids
+    size_t trapezoids_created{ 0 };
+    size_t trapezoids_destroyed{ 0 };
 };
 
 struct TrapezoidData
@@ -53,15 +97,120 @@ struct TrapezoidData
     std::vector<frm::Point> ends_of_line_segment;
     std::vector<LineSegment> line_segments;
     std::vector<Trapezoid> trapezoids;
+    std::vector<GraphNode> graph_nodes;
+
+    // outside rectangle, its corners are placed after ends of dcel
+    uint32_t top_line_segment_index{ null_trapezoid_data_index };
+    uint32_t bottom_line_segment_index{ null_trapezoid_data_index };
+
+    // line segments which are removed but still used by nodes of graph
+    std::vector<uint32_t> removed_line_segments;
+    // line segments which are not used by graph, they are reused by insertion
+    std::vector<uint32_t> free_line_segments;
+    // trapezoids which are merged by removal, their records are reused by insertion
+    std::vector<uint32_t> free_trapezoids;
+
+    // order of insertion of line segments, graph is rebuilt with the same seed
+    size_t seed{ 0 };
+
+    // not owned, nullptr => statistics are not collected
+    TrapezoidBuildStatistics * build_statistics{ nullptr };
 };
 
 
 // first parameter is outside face
-using trapezoid_data_and_graph_root_t = std::pair<size_t, std::pair<TrapezoidData, std::shared_ptr<GraphNode>>>;
+// graph root is index in TrapezoidData::graph_nodes
+using trapezoid_data_and_graph_root_t = std::pair<size_t, std::pair<TrapezoidData, uint32_t>>;
 
-// O(nlog(n))
+// O(nlog(n)) expected
 trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root(frm::dcel::DCEL const & dcel) noexcept(!IS_DEBUG);
 
+// O(nlog(n)) expected, line segments are inserted in random order given by seed
+// build_statistics != nullptr => counters of construction are added to it
+trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root_with_seed(
+    frm::dcel::DCEL const & dcel,
+    size_t seed,
+    TrapezoidBuildStatistics * build_statistics = nullptr
+) noexcept(!IS_DEBUG);
+
+// seeds seed, seed + 1, ... are tried until the longest query path is at most path_length_factor * log2(n)
+// if no build of retries_count fits, the one with the shortest longest path is returned
+// result depends only on seed, not on threads_count; threads_count == 0 => hardware concurrency
+trapezoid_data_and_graph_root_t generate_trapezoid_data_and_graph_root_with_bounded_path_length(
+    frm::dcel::DCEL const & dcel,
+    size_t seed,
+    size_t retries_count,
+    float path_length_factor = 4.f,
+    size_t threads_count = 0
+) noexcept(!IS_DEBUG);
+
+// O(n), number of inner nodes on the longest path from root to leaf
+size_t get_max_graph_path_length(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG);
+
+
+// O(1), child of x-node or y-node which is passed by query of point
+template<GraphNode::Type type>
+uint32_t get_next_graph_node_index(TrapezoidData const & trapezoid_data, GraphNode const & current_node, frm::Point point) noexcept;
+
+template<>
+uint32_t get_next_graph_node_index<GraphNode::Type::XUnit>(TrapezoidData const & trapezoid_data, GraphNode const & current_node, frm::Point point) noexcept;
+
+template<>
+uint32_t get_next_graph_node_index<GraphNode::Type::YUnit>(TrapezoidData const & trapezoid_data, GraphNode const & current_node, frm::Point point) noexcept;
+
+
+// O(1), index of new end for insert_line_segment
+size_t add_end_of_line_segment(trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root, frm::Point point) noexcept;
+
+// edit of dcel is mirrored by edits of line segments and faces:
+// - removal of edge merges faces, removed face is replaced by kept one with replace_face_index
+// - insertion of edge splits face, line segments of moved boundary get new face with set_line_segment_faces
+// - faces of inserted line segment are given to insert_line_segment
+// edges are removed before edges which cross them are inserted, line segments never cross
+
+// O(log(n) + k) expected amortized, where k is number of trapezoids crossed by line segment, returns index of line segment
+// line segment must not cross other line segments, ends may be given in any order
+// graph is rebuilt with the same seed if line segment goes out of outside rectangle
+size_t insert_line_segment(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t begin_index,
+    size_t end_index,
+    size_t face_over_line,
+    size_t face_under_line
+) noexcept(!IS_DEBUG);
+
+// O(log(n) + k) expected amortized, where k is number of trapezoids next to line segment
+// trapezoids over and under line segment are merged, faces of other line segments are not changed
+// graph is rebuilt with the same seed when removed line segments are more than a half of inserted
+void remove_line_segment(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t line_segment_index
+) noexcept(!IS_DEBUG);
+
+// O(1)
+void set_line_segment_faces(
+    trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root,
+    size_t line_segment_index,
+    size_t face_over_line,
+    size_t face_under_line
+) noexcept(!IS_DEBUG);
+
+// O(n), every line segment and outside face get new_face_index instead of old_face_index
+void replace_face_index(trapezoid_data_and_graph_root_t & trapezoid_data_and_graph_root, size_t old_face_index, size_t new_face_index) noexcept;
+
 
 // O(log(n))
-size_t get_face_index(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG);
\ No newline at end of file
+size_t get_face_index(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG);
+
+// O(log(n)), first line segment over or under point
+// returns null_trapezoid_data_index if there is only outside rectangle
+size_t get_line_segment_over_point(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG);
+size_t get_line_segment_under_point(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root, frm::Point point) noexcept(!IS_DEBUG);
+
+// O(log(n) + k + mlog(n)), where k is number of trapezoids and m is number of line segments crossed by query line segment
+// trapezoids are listed from begin to end, query line segment must be inside outside rectangle
+std::vector<size_t> get_trapezoids_crossed_by_line_segment(
+    trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root,
+    frm::Point begin,
+    frm::Point end
+) noexcept(!IS_DEBUG);
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "trapezoidal_decomposition_statistics.h"
+
+#include <cassert>
+#include <sstream>
+
+
+// number of inner nodes passed by query of point
+size_t get_query_path_length(TrapezoidData const & trapezoid_data, uint32_t root, frm::Point point) noexcept(!IS_DEBUG)
+{
+    size_t path_length = 0;
+    uint32_t current = root;
+
+    while (trapezoid_data.graph_nodes[current].type != GraphNode::Type::Leaf)
+    {
+        GraphNode const & node = trapezoid_data.graph_nodes[current];
+
+        switch (node.type)
+        {
+        case GraphNode::Type::XUnit:
+            current = get_next_graph_node_index<GraphNode::Type::XUnit>(trapezoid_data, node, point);
+            break;
+        case GraphNode::Type::YUnit:
+            current = get_next_graph_node_index<GraphNode::Type::YUnit>(trapezoid_data, node, point);
+            break;
+        default:
+            assert("Undefined graph node type" && false);
+            return path_length;
+        }
+
+        ++path_length;
+    }
+
+    return path_length;
+}
+
+TrapezoidGraphStatistics get_trapezoid_graph_statistics(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG)
+{
+    TrapezoidData const & trapezoid_data = trapezoid_data_and_graph_root.second.first;
+    uint32_t const root = trapezoid_data_and_graph_root.second.second;
+
+    TrapezoidGraphStatistics statistics{};
+
+    for (GraphNode const & node : trapezoid_data.graph_nodes)
+    {
+        switch (node.type)
+        {
+        case GraphNode::Type::Leaf:
+            ++statistics.leaf_nodes_count;
+            break;
+        case GraphNode::Type::XUnit:
+            ++statistics.x_unit_nodes_count;
+            break;
+        case GraphNode::Type::YUnit:
+            ++statistics.y_unit_nodes_count;
+            break;
+        default:
+            assert("Undefined graph node type" && false);
+        }
+    }
+
+    statistics.ends_count = trapezoid_data.ends_of_line_segment.size();
+    statistics.line_segments_count = trapezoid_data.line_segments.size() - trapezoid_data.free_line_segments.size();
+    statistics.removed_line_segments_count = trapezoid_data.removed_line_segments.size();
+    statistics.trapezoids_count = trapezoid_data.trapezoids.size() - trapezoid_data.free_trapezoids.size();
+
+    statistics.max_path_length = get_max_graph_path_length(trapezoid_data_and_graph_root);
+    statistics.path_length_histogram.resize(statistics.max_path_length + 1, 0);
+
+    auto const get_y = [&trapezoid_data](uint32_t line_segment_index, float x) noexcept -> float
+    {
+        LineSegment const & line_segment = trapezoid_data.line_segments[line_segment_index];
+        return line_segment.k * x + line_segment.c;
+    };
+
+    size_t counted_trapezoids_count = 0;
+    double path_lengths_sum = 0.;
+    double weighted_path_lengths_sum = 0.;
+    double area_sum = 0.;
+
+    for (Trapezoid const & trapezoid : trapezoid_data.trapezoids)
+    {
+        // free record has no leaf
+        if (trapezoid.trapezoid_node == null_graph_node_index)
+        {
+            continue;
+        }
+
+        float const left = trapezoid_data.ends_of_line_segment[trapezoid.left_end_index].x;
+        float const right = trapezoid_data.ends_of_line_segment[trapezoid.right_end_index].x;
+        float const middle_x = (left + right) / 2.f;
+
+        float const top = get_y(trapezoid.top_line_segment_index, middle_x);
+        float const bottom = get_y(trapezoid.bottom_line_segment_index, middle_x);
+
+        // area of trapezoid is width multiplied by height in the middle
+        double const area = static_cast<double>(right - left) * static_cast<double>(top - bottom);
+
+        if (area <= 0.)
+        {
+            continue;
+        }
+
+        size_t const path_length = get_query_path_length(trapezoid_data, root, { middle_x, (top + bottom) / 2.f });
+
+        ++statistics.path_length_histogram[std::min(path_length, statistics.max_path_length)];
+
+        ++counted_trapezoids_count;
+        path_lengths_sum += static_cast<double>(path_length);
+        weighted_path_lengths_sum += area * static_cast<double>(path_length);
+        area_sum += area;
+    }
+
+    if (counted_trapezoids_count != 0)
+    {
+        statistics.mean_path_length = path_lengths_sum / static_cast<double>(counted_trapezoids_count);
+        statistics.expected_query_path_length = weighted_path_lengths_sum / area_sum;
+    }
+
+    statistics.bytes_used = sizeof(TrapezoidData) +
+        trapezoid_data.ends_of_line_segment.capacity() * sizeof(frm::Point) +
+        trapezoid_data.line_segments.capacity() * sizeof(LineSegment) +
+        trapezoid_data.trapezoids.capacity() * sizeof(Trapezoid) +
+        trapezoid_data.graph_nodes.capacity() * sizeof(GraphNode) +
+        trapezoid_data.removed_line_segments.capacity() * sizeof(uint32_t) +
+        trapezoid_data.free_line_segments.capacity() * sizeof(uint32_t) +
+        trapezoid_data.free_trapezoids.capacity() * sizeof(uint32_t);
+
+    return statistics;
+}
+
+std::string get_trapezoid_statistics_json(
+    TrapezoidGraphStatistics const & graph_statistics,
+    TrapezoidBuildStatistics const * build_statistics
+) noexcept(!IS_DEBUG)
+{
+    std::ostringstream json{};
+
+    json << "{\"nodes\":{"
+        << "\"leaf\":" << graph_statistics.leaf_nodes_count << ','
+        << "\"x_unit\":" << graph_statistics.x_unit_nodes_count << ','
+        << "\"y_unit\":" << graph_statistics.y_unit_nodes_count << "},"
+        << "\"ends\":" << graph_statistics.ends_count << ','
+        << "\"line_segments\":" << graph_statistics.line_segments_count << ','
+        << "\"removed_line_segments\":" << graph_statistics.removed_line_segments_count << ','
+        << "\"trapezoids\":" << graph_statistics.trapezoids_count << ','
+        << "\"max_path_length\":" << graph_statistics.max_path_length << ','
+        << "\"path_length_histogram\":[";
+
+    for (size_t i = 0; i < graph_statistics.path_length_histogram.size(); ++i)
+    {
+        json << (i == 0 ? "" : ",") << graph_statistics.path_length_histogram[i];
+    }
+
+    json << "],"
+        << "\"mean_path_length\":" << graph_statistics.mean_path_length << ','
+        << "\"expected_query_path_length\":" << graph_statistics.expected_query_path_length << ','
+        << "\"bytes_used\":" << graph_statistics.bytes_used;
+
+    if (build_statistics != nullptr)
+    {
+        char const * const handler_names[TrapezoidBuildStatistics::handlers_count] = {
+            "inside_one_trapezoid",
+            "first_trapezoid_with_existing_vertex",
+            "first_trapezoid_without_existing_vertex",
+            "middle_trapezoid",
+            "last_trapezoid_with_existing_vertex",
+            "last_trapezoid_without_existing_vertex"
+        };
+
+        json << ",\"build\":{"
+            << "\"inserted_line_segments\":" << build_statistics->inserted_line_segments << ','
+            << "\"insertion_time_ns\":" << build_statistics->insertion_time.count() << ','
+            << "\"trapezoids_created\":" << build_statistics->trapezoids_created << ','
+            << "\"trapezoids_destroyed\":" << build_statistics->trapezoids_destroyed << ','
+            << "\"handlers\":{";
+
+        for (size_t i = 0; i < TrapezoidBuildStatistics::handlers_count; ++i)
+        {
+            json << (i == 0 ? "" : ",")
+                << '"' << handler_names[i] << "\":{"
+                << "\"calls\":" << build_statistics->handler_calls[i] << ','
+                << "\"time_ns\":" << build_statistics->handler_times[i].count() << '}';
+        }
+
+        json << "}}";
+    }
+
+    json << '}';
+
+    return json.str();
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+
+#include "trapezoidal_decomposition.h"
+
+#include <string>
+
+
+struct TrapezoidGraphStatistics
+{
+    size_t leaf_nodes_count{ 0 };
+    size_t x_unit_nodes_count{ 0 };
+    size_t y_unit_nodes_count{ 0 };
+
+    size_t ends_count{ 0 };
+    size_t line_segments_count{ 0 };
+    size_t removed_line_segments_count{ 0 };
+    size_t trapezoids_count{ 0 };
+
+    // number of inner nodes on the longest path from root to leaf
+    size_t max_path_length{ 0 };
+
+    // i-th value is number of trapezoids which are found by query path of length i from their centre
+    // trapezoids of zero area are not counted
+    std::vector<size_t> path_length_histogram;
+    // mean over trapezoids and mean over points of outside rectangle, every trapezoid is weighted by its area
+    double mean_path_length{ 0. };
+    double expected_query_path_length{ 0. };
+
+    // capacity of arrays of TrapezoidData
+    size_t bytes_used{ 0 };
+};
+
+
+// O(nlog(n))
+TrapezoidGraphStatistics get_trapezoid_graph_statistics(trapezoid_data_and_graph_root_t const & trapezoid_data_and_graph_root) noexcept(!IS_DEBUG);
+
+// one JSON object, build statistics are written if they are given
+std::string get_trapezoid_statistics_json(
+    TrapezoidGraphStatistics const & graph_statistics,
+    TrapezoidBuildStatistics const * build_statistics = nullptr
+) noexcept(!IS_DEBUG);
\ No newline at end of file